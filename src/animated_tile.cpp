@@ -8,15 +8,47 @@
 /** @file animated_tile.cpp Everything related to animated tiles. */
 
 #include "stdafx.h"
-#include "core/container_func.hpp"
 #include "tile_cmd.h"
 #include "viewport_func.h"
 #include "framerate_type.h"
+#include "timer/timer_game_tick.h"
 
 #include "safeguards.h"
 
-/** The table/list with animated tiles. */
+/**
+ * The table/list with animated tiles, ordered by the animation speed they were last animated with.
+ * Tiles of the same speed are in the order they were added.
+ */
 std::vector<TileIndex> _animated_tiles;
+/**
+ * The animation speed of each tile in #_animated_tiles, in ascending order. A tile with speed \c s
+ * only changes frame on ticks that are a multiple of 2 to the power of \c s, so only the front
+ * of the list needs to be visited on most ticks. Tiles that do not tell their speed have speed 0.
+ */
+std::vector<uint8_t> _animated_tile_speeds;
+
+/** A change to the animated tile list, made while the animated tiles were being animated. */
+struct AnimatedTileChange {
+	TileIndex tile; ///< The tile that is changed.
+	uint8_t speed;  ///< The new animation speed of the tile.
+	bool add;       ///< Whether the tile is added to the list, otherwise its speed is changed.
+};
+
+static bool _animating_tiles = false; ///< Whether AnimateAnimatedTiles is running, so additions and speed changes have to wait.
+static size_t _cur_animated_tile = 0; ///< Index in #_animated_tiles of the tile being animated.
+static std::vector<AnimatedTileChange> _animated_tile_changes; ///< Changes to apply once all tiles of the tick have been animated.
+
+/**
+ * Insert a tile in the animated tile table, after the other tiles with the same speed.
+ * @param tile the tile to insert
+ * @param speed the animation speed of the tile
+ */
+static void InsertAnimatedTile(TileIndex tile, uint8_t speed)
+{
+	size_t index = std::upper_bound(_animated_tile_speeds.begin(), _animated_tile_speeds.end(), speed) - _animated_tile_speeds.begin();
+	_animated_tiles.insert(_animated_tiles.begin() + index, tile);
+	_animated_tile_speeds.insert(_animated_tile_speeds.begin() + index, speed);
+}
 
 /**
  * Removes the given tile from the animated tile table.
@@ -24,9 +56,15 @@ std::vector<TileIndex> _animated_tiles;
  */
 void DeleteAnimatedTile(TileIndex tile)
 {
+	if (_animating_tiles) {
+		/* Forget earlier changes, a later AddAnimatedTile starts afresh. */
+		_animated_tile_changes.erase(std::remove_if(_animated_tile_changes.begin(), _animated_tile_changes.end(), [tile](const AnimatedTileChange &change) { return change.tile == tile; }), _animated_tile_changes.end());
+	}
+
 	auto to_remove = std::find(_animated_tiles.begin(), _animated_tiles.end(), tile);
 	if (to_remove != _animated_tiles.end()) {
 		/* The order of the remaining elements must stay the same, otherwise the animation loop may miss a tile. */
+		_animated_tile_speeds.erase(_animated_tile_speeds.begin() + (to_remove - _animated_tiles.begin()));
 		_animated_tiles.erase(to_remove);
 		MarkTileDirtyByTile(tile);
 	}
@@ -40,19 +78,57 @@ void DeleteAnimatedTile(TileIndex tile)
 void AddAnimatedTile(TileIndex tile)
 {
 	MarkTileDirtyByTile(tile);
-	include(_animated_tiles, tile);
+
+	if (_animating_tiles) {
+		_animated_tile_changes.push_back({tile, 0, true});
+		return;
+	}
+
+	if (std::find(_animated_tiles.begin(), _animated_tiles.end(), tile) == _animated_tiles.end()) InsertAnimatedTile(tile, 0);
+}
+
+/**
+ * Set the animation speed of an animated tile, i.e.\ the tile only changes
+ * frame on ticks that are a multiple of 2 to the power of \a speed.
+ * Nothing happens when the tile is not in the animated tile table.
+ * @param tile the animated tile
+ * @param speed the animation speed of the tile
+ */
+void SetAnimatedTileSpeed(TileIndex tile, uint8_t speed)
+{
+	if (_animating_tiles) {
+		/* Usually it is the tile being animated that keeps its speed. */
+		if (_cur_animated_tile < _animated_tiles.size() && _animated_tiles[_cur_animated_tile] == tile && _animated_tile_speeds[_cur_animated_tile] == speed) return;
+
+		_animated_tile_changes.push_back({tile, speed, false});
+		return;
+	}
+
+	auto it = std::find(_animated_tiles.begin(), _animated_tiles.end(), tile);
+	if (it == _animated_tiles.end()) return;
+
+	size_t index = it - _animated_tiles.begin();
+	if (_animated_tile_speeds[index] == speed) return;
+
+	_animated_tiles.erase(it);
+	_animated_tile_speeds.erase(_animated_tile_speeds.begin() + index);
+	InsertAnimatedTile(tile, speed);
 }
 
 /**
- * Animate all tiles in the animated tile list, i.e.\ call AnimateTile on them.
+ * Animate all tiles in the animated tile list whose animation can advance this tick, i.e.\ call AnimateTile on them.
  */
 void AnimateAnimatedTiles()
 {
 	PerformanceAccumulator framerate(PFE_GL_LANDSCAPE);
 
-	const TileIndex *ti = _animated_tiles.data();
-	while (ti < _animated_tiles.data() + _animated_tiles.size()) {
-		const TileIndex curr = *ti;
+	/* Tiles with a speed up to the number of trailing zero bits of the tick counter are due. */
+	const uint max_speed = TimerGameTick::counter == 0 ? UINT8_MAX : FindFirstBit(TimerGameTick::counter);
+
+	_animating_tiles = true;
+	_cur_animated_tile = 0;
+	while (_cur_animated_tile < _animated_tiles.size() && _animated_tile_speeds[_cur_animated_tile] <= max_speed) {
+		const TileIndex curr = _animated_tiles[_cur_animated_tile];
 		AnimateTile(curr);
 		/* During the AnimateTile call, DeleteAnimatedTile could have been called,
 		 * deleting an element we've already processed and pushing the rest one
@@ -63,8 +139,19 @@ void AnimateAnimatedTiles()
 		 *       deleted during the same AnimateTile call, but no code seems to
 		 *       be doing this anyway.
 		 */
-		if (*ti == curr) ++ti;
+		if (_cur_animated_tile < _animated_tiles.size() && _animated_tiles[_cur_animated_tile] == curr) ++_cur_animated_tile;
+	}
+	_animating_tiles = false;
+
+	/* Additions and speed changes move tiles around in the table, so they are only done now. */
+	for (const AnimatedTileChange &change : _animated_tile_changes) {
+		if (change.add) {
+			AddAnimatedTile(change.tile);
+		} else {
+			SetAnimatedTileSpeed(change.tile, change.speed);
+		}
 	}
+	_animated_tile_changes.clear();
 }
 
 /**
@@ -73,4 +160,6 @@ void AnimateAnimatedTiles()
 void InitializeAnimatedTiles()
 {
 	_animated_tiles.clear();
+	_animated_tile_speeds.clear();
+	_animated_tile_changes.clear();
 }
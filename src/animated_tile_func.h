@@ -14,6 +14,7 @@
 
 void AddAnimatedTile(TileIndex tile);
 void DeleteAnimatedTile(TileIndex tile);
+void SetAnimatedTileSpeed(TileIndex tile, uint8_t speed);
 void AnimateAnimatedTiles();
 void InitializeAnimatedTiles();
 
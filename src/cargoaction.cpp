@@ -107,7 +107,7 @@ bool CargoDelivery::operator()(CargoPacket *cp)
 {
 	uint remove = this->Preprocess(cp);
 	this->source->RemoveFromMeta(cp, VehicleCargoList::MTA_DELIVER, remove);
-	this->payment->PayFinalDelivery(cp, remove);
+	this->payment->PayFinalDelivery(cp, remove, this->source->PeriodsInTransit(cp));
 	return this->Postprocess(cp, remove);
 }
 
@@ -153,6 +153,7 @@ bool CargoReturn::operator()(CargoPacket *cp)
 	if (cp_new == nullptr) cp_new = cp;
 	assert(cp_new->Count() <= this->destination->reserved_count);
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_LOAD, cp_new->Count());
+	this->source->SettleAge(cp_new);
 	this->destination->reserved_count -= cp_new->Count();
 	this->destination->Append(cp_new, this->next);
 	return cp_new == cp;
@@ -168,6 +169,7 @@ bool CargoTransfer::operator()(CargoPacket *cp)
 	CargoPacket *cp_new = this->Preprocess(cp);
 	if (cp_new == nullptr) return false;
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
+	this->source->SettleAge(cp_new);
 	/* No transfer credits here as they were already granted during Stage(). */
 	this->destination->Append(cp_new, cp_new->NextStation());
 	return cp_new == cp;
@@ -183,6 +185,7 @@ bool CargoShift::operator()(CargoPacket *cp)
 	CargoPacket *cp_new = this->Preprocess(cp);
 	if (cp_new == nullptr) cp_new = cp;
 	this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_KEEP, cp_new->Count());
+	this->source->SettleAge(cp_new);
 	this->destination->Append(cp_new, VehicleCargoList::MTA_KEEP);
 	return cp_new == cp;
 }
@@ -224,7 +227,9 @@ bool VehicleCargoReroute::operator()(CargoPacket *cp)
 	}
 	if (this->source != this->destination) {
 		this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
+		this->source->SettleAge(cp_new);
 		this->destination->AddToMeta(cp_new, VehicleCargoList::MTA_TRANSFER);
+		this->destination->AdoptAge(cp_new);
 	}
 
 	/* Legal, as front pushing doesn't invalidate iterators in std::list. */
@@ -14,6 +14,7 @@
 #include "economy_base.h"
 #include "cargoaction.h"
 #include "order_type.h"
+#include <unordered_map>
 
 #include "safeguards.h"
 
@@ -28,6 +29,7 @@ CargoPacket::CargoPacket()
 {
 	this->source_type = SourceType::Industry;
 	this->source_id   = INVALID_SOURCE;
+	this->aging_epoch = 0;
 }
 
 /**
@@ -48,7 +50,8 @@ CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16_t count,
 	source_id(source_id),
 	source(source),
 	source_xy(source_xy),
-	loaded_at_xy(0)
+	loaded_at_xy(0),
+	aging_epoch(0)
 {
 	assert(count != 0);
 	this->source_type  = source_type;
@@ -75,7 +78,8 @@ CargoPacket::CargoPacket(uint16_t count, uint16_t periods_in_transit, StationID
 		source_id(source_id),
 		source(source),
 		source_xy(source_xy),
-		loaded_at_xy(loaded_at_xy.value)
+		loaded_at_xy(loaded_at_xy.value),
+		aging_epoch(0)
 {
 	assert(count != 0);
 	this->source_type = source_type;
@@ -92,6 +96,7 @@ CargoPacket *CargoPacket::Split(uint new_size)
 
 	Money fs = this->FeederShare(new_size);
 	CargoPacket *cp_new = new CargoPacket(new_size, this->periods_in_transit, this->source, this->source_xy, this->loaded_at_xy, fs, this->source_type, this->source_id);
+	cp_new->aging_epoch = this->aging_epoch;
 	this->feeder_share -= fs;
 	this->count -= new_size;
 	return cp_new;
@@ -171,7 +176,7 @@ void CargoList<Tinst, Tcont>::OnCleanPool()
 
 /**
  * Update the cached values to reflect the removal of this packet or part of it.
- * Decreases count and periods_in_transit.
+ * Decreases count.
  * @param cp Packet to be removed from cache.
  * @param count Amount of cargo from the given packet to be removed.
  */
@@ -179,20 +184,18 @@ template <class Tinst, class Tcont>
 void CargoList<Tinst, Tcont>::RemoveFromCache(const CargoPacket *cp, uint count)
 {
 	assert(count <= cp->count);
-	this->count                 -= count;
-	this->cargo_periods_in_transit -= static_cast<uint64_t>(cp->periods_in_transit) * count;
+	this->count -= count;
 }
 
 /**
  * Update the cache to reflect adding of this packet.
- * Increases count and periods_in_transit.
+ * Increases count.
  * @param cp New packet to be inserted.
  */
 template <class Tinst, class Tcont>
 void CargoList<Tinst, Tcont>::AddToCache(const CargoPacket *cp)
 {
-	this->count                 += cp->count;
-	this->cargo_periods_in_transit += static_cast<uint64_t>(cp->periods_in_transit) * cp->count;
+	this->count += cp->count;
 }
 
 /** Invalidates the cached data and rebuilds it. */
@@ -200,7 +203,6 @@ template <class Tinst, class Tcont>
 void CargoList<Tinst, Tcont>::InvalidateCache()
 {
 	this->count = 0;
-	this->cargo_periods_in_transit = 0;
 
 	for (ConstIterator it(this->packets.begin()); it != this->packets.end(); it++) {
 		static_cast<Tinst *>(this)->AddToCache(*it);
@@ -253,6 +255,7 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 	assert(action == MTA_LOAD ||
 			(action == MTA_KEEP && this->action_counts[MTA_LOAD] == 0));
 	this->AddToMeta(cp, action);
+	this->AdoptAge(cp);
 
 	if (this->count == cp->count) {
 		this->packets.push_back(cp);
@@ -262,6 +265,7 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 	uint sum = cp->count;
 	for (ReverseIterator it(this->packets.rbegin()); it != this->packets.rend(); it++) {
 		CargoPacket *icp = *it;
+		this->SettleAge(icp);
 		if (VehicleCargoList::TryMerge(icp, cp)) return;
 		sum += icp->count;
 		if (sum >= this->action_counts[action]) {
@@ -326,7 +330,7 @@ void VehicleCargoList::PopCargo(Taction action)
 
 /**
  * Update the cached values to reflect the removal of this packet or part of it.
- * Decreases count, feeder share and periods_in_transit.
+ * Decreases count and feeder share.
  * @param cp Packet to be removed from cache.
  * @param count Amount of cargo from the given packet to be removed.
  */
@@ -338,7 +342,7 @@ void VehicleCargoList::RemoveFromCache(const CargoPacket *cp, uint count)
 
 /**
  * Update the cache to reflect adding of this packet.
- * Increases count, feeder share and periods_in_transit.
+ * Increases count and feeder share.
  * @param cp New packet to be inserted.
  */
 void VehicleCargoList::AddToCache(const CargoPacket *cp)
@@ -376,17 +380,19 @@ void VehicleCargoList::AddToMeta(const CargoPacket *cp, MoveToAction action)
 }
 
 /**
- * Ages the all cargo in this list.
+ * Returns average number of cargo aging periods in transit for a cargo entity.
+ * As the packets age lazily, this is calculated on demand.
+ * @return The before mentioned number.
  */
-void VehicleCargoList::AgeCargo()
+uint VehicleCargoList::PeriodsInTransit() const
 {
-	for (const auto &cp : this->packets) {
-		/* If we're at the maximum, then we can't increase no more. */
-		if (cp->periods_in_transit == UINT16_MAX) continue;
+	if (this->count == 0) return 0;
 
-		cp->periods_in_transit++;
-		this->cargo_periods_in_transit += cp->count;
+	uint64_t cargo_periods_in_transit = 0;
+	for (const CargoPacket *cp : this->packets) {
+		cargo_periods_in_transit += static_cast<uint64_t>(this->PeriodsInTransit(cp)) * cp->count;
 	}
+	return cargo_periods_in_transit / this->count;
 }
 
 /**
@@ -518,7 +524,7 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 			case MTA_TRANSFER:
 				this->packets.push_front(cp);
 				/* Add feeder share here to allow reusing field for next station. */
-				share = payment->PayTransfer(cp, cp->count);
+				share = payment->PayTransfer(cp, cp->count, this->PeriodsInTransit(cp));
 				cp->AddFeederShare(share);
 				this->feeder_share += share;
 				cp->next_station = cargo_next;
@@ -678,6 +684,36 @@ uint VehicleCargoList::Reroute(uint max_move, VehicleCargoList *dest, StationID
  *
  */
 
+/**
+ * Update the cached values to reflect the removal of this packet or part of it.
+ * Decreases count and periods_in_transit.
+ * @param cp Packet to be removed from cache.
+ * @param count Amount of cargo from the given packet to be removed.
+ */
+void StationCargoList::RemoveFromCache(const CargoPacket *cp, uint count)
+{
+	this->cargo_periods_in_transit -= static_cast<uint64_t>(cp->periods_in_transit) * count;
+	this->Parent::RemoveFromCache(cp, count);
+}
+
+/**
+ * Update the cache to reflect adding of this packet.
+ * Increases count and periods_in_transit.
+ * @param cp New packet to be inserted.
+ */
+void StationCargoList::AddToCache(const CargoPacket *cp)
+{
+	this->cargo_periods_in_transit += static_cast<uint64_t>(cp->periods_in_transit) * cp->count;
+	this->Parent::AddToCache(cp);
+}
+
+/** Invalidates the cached data and rebuilds it. */
+void StationCargoList::InvalidateCache()
+{
+	this->cargo_periods_in_transit = 0;
+	this->Parent::InvalidateCache();
+}
+
 /**
  * Appends the given cargo packet to the range of packets with the same next station
  * @warning After appending this packet may not exist anymore!
@@ -861,6 +897,53 @@ uint StationCargoList::Reroute(uint max_move, StationCargoList *dest, StationID
 	return this->ShiftCargo(StationCargoReroute(this, dest, max_move, avoid, avoid2, ge), avoid, false);
 }
 
+/**
+ * Merges packets waiting for the same next hop that could have been merged
+ * when they were appended. Rerouting cargo inserts packets without trying to
+ * merge them, so over time many small packets with the same origin pile up.
+ * The cargo of a merged packet joins the first earlier packet it fits in, the
+ * order of the other packets is kept.
+ * @param dry_run Only count the packets that could be merged, do not merge them.
+ * @return Number of packets that were (or could be) merged into other packets.
+ */
+uint StationCargoList::Compact(bool dry_run)
+{
+	uint merged = 0;
+	/* Earlier packet that later ones can be merged into, with its (projected) count. */
+	std::unordered_map<uint64_t, std::pair<CargoPacket *, uint>> targets;
+
+	for (auto &[next, list] : this->packets) {
+		if (list.size() < 2) continue;
+
+		targets.clear();
+		for (auto it = list.begin(); it != list.end(); /* nothing */) {
+			CargoPacket *cp = *it;
+			uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(cp->source_xy)) | static_cast<uint64_t>(cp->periods_in_transit) << 32 | static_cast<uint64_t>(cp->source_id) << 48;
+
+			auto [target, inserted] = targets.try_emplace(key, cp, cp->count);
+			if (!inserted) {
+				auto &[icp, count] = target->second;
+				if (StationCargoList::AreMergable(icp, cp) && count + cp->count <= CargoPacket::MAX_COUNT) {
+					count += cp->count;
+					merged++;
+					if (dry_run) {
+						++it;
+					} else {
+						icp->Merge(cp);
+						it = list.erase(it);
+					}
+					continue;
+				}
+				/* The earlier packet is full or just shares the key, continue with this one. */
+				target->second = {cp, cp->count};
+			}
+			++it;
+		}
+	}
+
+	return merged;
+}
+
 /*
  * We have to instantiate everything we want to be usable.
  */
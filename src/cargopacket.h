@@ -52,6 +52,7 @@ private:
 		TileOrStationID loaded_at_xy; ///< Location where this cargo has been loaded into the vehicle.
 		TileOrStationID next_station; ///< Station where the cargo wants to go next.
 	};
+	uint32_t aging_epoch;   ///< VehicleCargoList::aging_epoch of the vehicle carrying the packet when \c periods_in_transit was last brought up to date.
 
 	/** The CargoList caches, thus needs to know about it. */
 	template <class Tinst, class Tcont> friend class CargoList;
@@ -127,6 +128,8 @@ public:
 	 * By default a period is 2.5 days (CARGO_AGING_TICKS = 185 ticks), however
 	 * vehicle NewGRFs can overide the length of the cargo aging period. The
 	 * value is capped at UINT16_MAX.
+	 * @note For cargo in a vehicle this does not include the aging since the
+	 *       packet was loaded, use VehicleCargoList::PeriodsInTransit instead.
 	 * @return Length this cargo has been in transit.
 	 */
 	inline uint16_t PeriodsInTransit() const
@@ -222,7 +225,6 @@ public:
 
 protected:
 	uint count;                   ///< Cache for the number of cargo entities.
-	uint64_t cargo_periods_in_transit; ///< Cache for the sum of number of cargo aging periods in transit of each entity; comparable to man-hours.
 
 	Tcont packets;              ///< The cargo packets in this list.
 
@@ -249,15 +251,6 @@ public:
 		return &this->packets;
 	}
 
-	/**
-	 * Returns average number of cargo aging periods in transit for a cargo entity.
-	 * @return The before mentioned number.
-	 */
-	inline uint PeriodsInTransit() const
-	{
-		return this->count == 0 ? 0 : this->cargo_periods_in_transit / this->count;
-	}
-
 	void InvalidateCache();
 };
 
@@ -273,6 +266,7 @@ protected:
 
 	Money feeder_share;                     ///< Cache for the feeder share.
 	uint action_counts[NUM_MOVE_TO_ACTION]; ///< Counts of cargo to be transferred, delivered, kept and loaded.
+	uint32_t aging_epoch;                   ///< Number of times the cargo in this list has been aged.
 
 	template<class Taction>
 	void ShiftCargo(Taction action);
@@ -297,6 +291,26 @@ protected:
 	void AddToMeta(const CargoPacket *cp, MoveToAction action);
 	void RemoveFromMeta(const CargoPacket *cp, MoveToAction action, uint count);
 
+	/**
+	 * Bring the age of a packet in this list up to date, so the packet can
+	 * leave the list or be compared with other packets.
+	 * @param cp Packet in this list.
+	 */
+	inline void SettleAge(CargoPacket *cp) const
+	{
+		cp->periods_in_transit = this->PeriodsInTransit(cp);
+		cp->aging_epoch = this->aging_epoch;
+	}
+
+	/**
+	 * Let a packet with a settled age age along with this list from now on.
+	 * @param cp Packet that is added to this list.
+	 */
+	inline void AdoptAge(CargoPacket *cp) const
+	{
+		cp->aging_epoch = this->aging_epoch;
+	}
+
 	static MoveToAction ChooseAction(const CargoPacket *cp, StationID cargo_next,
 			StationID current_station, bool accepted, StationIDStack next_station);
 
@@ -325,6 +339,27 @@ public:
 		return this->count == 0 ? INVALID_STATION : this->packets.front()->source;
 	}
 
+	/**
+	 * Returns the number of cargo aging periods a packet in this list has been in transit.
+	 * @param cp Packet in this list.
+	 * @return Length the cargo has been in transit, capped at UINT16_MAX.
+	 */
+	inline uint16_t PeriodsInTransit(const CargoPacket *cp) const
+	{
+		return ClampTo<uint16_t>(cp->periods_in_transit + static_cast<uint64_t>(this->aging_epoch - cp->aging_epoch));
+	}
+
+	uint PeriodsInTransit() const;
+
+	/**
+	 * Ages all cargo in this list. The packets themselves are only updated
+	 * when they leave the list or their age is needed.
+	 */
+	inline void AgeCargo()
+	{
+		this->aging_epoch++;
+	}
+
 	/**
 	 * Returns total sum of the feeder share for all packets.
 	 * @return The before mentioned number.
@@ -392,8 +427,6 @@ public:
 
 	void Append(CargoPacket *cp, MoveToAction action = MTA_KEEP);
 
-	void AgeCargo();
-
 	void InvalidateCache();
 
 	void SetTransferLoadPlace(TileIndex xy);
@@ -426,6 +459,7 @@ public:
 	/**
 	 * Are the two CargoPackets mergeable in the context of
 	 * a list of CargoPackets for a Vehicle?
+	 * @pre The ages of both packets are settled.
 	 * @param cp1 First CargoPacket.
 	 * @param cp2 Second CargoPacket.
 	 * @return True if they are mergeable.
@@ -452,6 +486,10 @@ protected:
 	typedef CargoList<StationCargoList, StationCargoPacketMap> Parent;
 
 	uint reserved_count; ///< Amount of cargo being reserved for loading.
+	uint64_t cargo_periods_in_transit; ///< Cache for the sum of number of cargo aging periods in transit of each entity; comparable to man-hours.
+
+	void AddToCache(const CargoPacket *cp);
+	void RemoveFromCache(const CargoPacket *cp, uint count);
 
 public:
 	/** The super class ought to know what it's doing. */
@@ -500,6 +538,17 @@ public:
 		return this->count == 0 ? INVALID_STATION : this->packets.begin()->second.front()->source;
 	}
 
+	/**
+	 * Returns average number of cargo aging periods in transit for a cargo entity.
+	 * @return The before mentioned number.
+	 */
+	inline uint PeriodsInTransit() const
+	{
+		return this->count == 0 ? 0 : this->cargo_periods_in_transit / this->count;
+	}
+
+	void InvalidateCache();
+
 	/**
 	 * Returns sum of cargo still available for loading at the sation.
 	 * (i.e. not counting cargo which is already reserved for loading)
@@ -538,6 +587,8 @@ public:
 	uint Truncate(uint max_move = UINT_MAX, StationCargoAmountMap *cargo_per_source = nullptr);
 	uint Reroute(uint max_move, StationCargoList *dest, StationID avoid, StationID avoid2, const GoodsEntry *ge);
 
+	uint Compact(bool dry_run = false);
+
 	/**
 	 * Are the two CargoPackets mergeable in the context of
 	 * a list of CargoPackets for a Station?
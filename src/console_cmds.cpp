@@ -36,15 +36,22 @@
 #include "ai/ai_config.hpp"
 #include "newgrf.h"
 #include "newgrf_profiling.h"
+#include "framerate_type.h"
 #include "console_func.h"
 #include "engine_base.h"
 #include "road.h"
 #include "rail.h"
+#include "station_base.h"
 #include "game/game.hpp"
 #include "table/strings.h"
 #include "3rdparty/fmt/chrono.h"
 #include "company_cmd.h"
 #include "misc_cmd.h"
+#include "train.h"
+#include "roadveh.h"
+#include "depot_map.h"
+#include "pathfinder/npf/npf_func.h"
+#include "pathfinder/yapf/yapf.h"
 
 #include <sstream>
 
@@ -1066,7 +1073,6 @@ DEF_CONSOLE_CMD(ConReturn)
 extern bool CloseConsoleLogIfActive();
 extern const std::vector<GRFFile *> &GetAllGRFFiles();
 extern void ConPrintFramerate(); // framerate_gui.cpp
-extern void ShowFramerateWindow();
 
 DEF_CONSOLE_CMD(ConScript)
 {
@@ -1734,6 +1740,137 @@ DEF_CONSOLE_CMD(ConCompanies)
 	return true;
 }
 
+/**
+ * Print the cargo packet statistics of a station.
+ * @param st The station to print the statistics of.
+ * @param[in,out] total_packets Total number of packets, incremented by the packets of this station.
+ * @param[in,out] total_mergeable Total number of mergeable packets, incremented by those of this station.
+ */
+static void PrintCargoPacketStats(Station *st, size_t &total_packets, size_t &total_mergeable)
+{
+	size_t packets = 0;
+	size_t mergeable = 0;
+	uint cargo = 0;
+	uint hops = 0;
+	for (GoodsEntry &ge : st->goods) {
+		for (const auto &it : *ge.cargo.Packets()) packets += it.second.size();
+		mergeable += ge.cargo.Compact(true);
+		cargo += ge.cargo.TotalCount();
+		hops += (uint)ge.cargo.Packets()->MapSize();
+	}
+	if (packets == 0) return;
+
+	/* Every packet costs its pool slot, the pointer to it and the list node holding that pointer. */
+	size_t memory = packets * (sizeof(CargoPacket) + sizeof(CargoPacket *) + sizeof(StationCargoPacketMap::List::value_type) + 2 * sizeof(void *));
+
+	SetDParam(0, st->index);
+	IConsolePrint(CC_DEFAULT, "{:5}: packets: {:7}, cargo: {:7}, next hops: {:3}, mergeable: {:6} ({:3}%), memory: {:9} bytes, '{}'",
+			st->index, packets, cargo, hops, mergeable, mergeable * 100 / packets, memory, GetString(STR_STATION_NAME));
+
+	total_packets += packets;
+	total_mergeable += mergeable;
+}
+
+DEF_CONSOLE_CMD(ConCargoPackets)
+{
+	if (argc == 0) {
+		IConsolePrint(CC_HELP, "Show how cargo waiting at stations is split into packets. Usage: 'cargo_packets [<station-id>]'.");
+		IConsolePrint(CC_HELP, "Mergeable packets are merged into other packets the next time the station is compacted.");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	size_t total_packets = 0;
+	size_t total_mergeable = 0;
+	if (argc == 2) {
+		uint32_t index;
+		if (!GetArgumentInteger(&index, argv[1]) || !Station::IsValidID(index)) {
+			IConsolePrint(CC_ERROR, "Unknown station '{}'.", argv[1]);
+			return true;
+		}
+		PrintCargoPacketStats(Station::Get(index), total_packets, total_mergeable);
+		return true;
+	}
+
+	for (Station *st : Station::Iterate()) {
+		PrintCargoPacketStats(st, total_packets, total_mergeable);
+	}
+
+	IConsolePrint(CC_INFO, "Total at stations: {} packets, {} mergeable.", total_packets, total_mergeable);
+	/* Slots below the highest used index that are free again are holes in the pool. */
+	IConsolePrint(CC_INFO, "Cargo packet pool: {} packets, {} slots allocated, {} free slots below the highest used slot.",
+			_cargopacket_pool.items, _cargopacket_pool.size, _cargopacket_pool.first_unused - _cargopacket_pool.items);
+	return true;
+}
+
+/**
+ * Time the nearest depot searches of all vehicles of a type with YAPF and with NPF.
+ * The searches are the same ones vehicles make when they need servicing,
+ * but nothing is done with the results, so running them does not change the game.
+ * @tparam T Type of the vehicles.
+ * @param name Name of the vehicle type to print.
+ * @param yapf Search with YAPF.
+ * @param npf Search with NPF.
+ */
+template <class T, class TYapf, class TNpf>
+static void BenchmarkDepotSearches(const char *name, TYapf yapf, TNpf npf)
+{
+	using namespace std::chrono;
+
+	uint searches = 0;
+	uint found_yapf = 0;
+	uint found_npf = 0;
+	uint same = 0;
+	steady_clock::duration time_yapf{};
+	steady_clock::duration time_npf{};
+
+	for (const T *v : T::Iterate()) {
+		if (!v->IsPrimaryVehicle() || (v->vehstatus & VS_CRASHED) != 0 || IsDepotTile(v->tile)) continue;
+
+		auto start = steady_clock::now();
+		FindDepotData result_yapf = yapf(v);
+		auto middle = steady_clock::now();
+		FindDepotData result_npf = npf(v);
+		auto end = steady_clock::now();
+
+		time_yapf += middle - start;
+		time_npf += end - middle;
+		searches++;
+		if (result_yapf.best_length != UINT_MAX) found_yapf++;
+		if (result_npf.best_length != UINT_MAX) found_npf++;
+		if (result_yapf.tile == result_npf.tile) same++;
+	}
+
+	if (searches == 0) {
+		IConsolePrint(CC_INFO, "{}: no vehicles to search from.", name);
+		return;
+	}
+	IConsolePrint(CC_INFO, "{}: {} searches, same depot {} times.", name, searches, same);
+	IConsolePrint(CC_DEFAULT, "  YAPF: {:8} us, {:6} us per search, {} depots found.",
+			duration_cast<microseconds>(time_yapf).count(), duration_cast<microseconds>(time_yapf).count() / searches, found_yapf);
+	IConsolePrint(CC_DEFAULT, "  NPF:  {:8} us, {:6} us per search, {} depots found.",
+			duration_cast<microseconds>(time_npf).count(), duration_cast<microseconds>(time_npf).count() / searches, found_npf);
+}
+
+DEF_CONSOLE_CMD(ConPathfinderBenchmark)
+{
+	if (argc == 0) {
+		IConsolePrint(CC_HELP, "Compare the speed of YAPF and NPF by searching the nearest depot of every train and road vehicle with both. Usage: 'pf_benchmark'.");
+		return true;
+	}
+
+	if (argc > 1) return false;
+
+	BenchmarkDepotSearches<Train>("Trains",
+			[](const Train *v) { return YapfTrainFindNearestDepot(v, 0); },
+			[](const Train *v) { return NPFTrainFindNearestDepot(v, 0); });
+	BenchmarkDepotSearches<RoadVehicle>("Road vehicles",
+			[](const RoadVehicle *v) { return YapfRoadVehicleFindNearestDepot(v, 0); },
+			[](const RoadVehicle *v) { return NPFRoadVehicleFindNearestDepot(v, 0); });
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConSay)
 {
 	if (argc == 0) {
@@ -2333,6 +2470,43 @@ DEF_CONSOLE_CMD(ConFramerate)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConFramerateTrace)
+{
+	if (argc == 0) {
+		IConsolePrint(CC_HELP, "Record a trace of the time spent in each part of the game loop. Sub-commands can be abbreviated.");
+		IConsolePrint(CC_HELP, "Usage: 'fps_trace start [<num-ticks>]':");
+		IConsolePrint(CC_HELP, "  Begin recording. If a number of ticks is provided, recording stops after that many game ticks. There are 74 ticks in a calendar day.");
+		IConsolePrint(CC_HELP, "Usage: 'fps_trace stop':");
+		IConsolePrint(CC_HELP, "  End recording and write the collected data to a JSON file in the Chrome trace event format.");
+		IConsolePrint(CC_HELP, "Usage: 'fps_trace abort':");
+		IConsolePrint(CC_HELP, "  End recording and discard all collected data.");
+		return true;
+	}
+
+	if (argc < 2) return false;
+
+	/* "start" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "sta")) {
+		uint64_t ticks = argc >= 3 ? std::max(atoi(argv[2]), 1) : 0;
+		StartPerformanceTrace(ticks);
+		return true;
+	}
+
+	/* "stop" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "sto")) {
+		FinishPerformanceTrace();
+		return true;
+	}
+
+	/* "abort" sub-command */
+	if (StrStartsWithIgnoreCase(argv[1], "abo")) {
+		AbortPerformanceTrace();
+		return true;
+	}
+
+	return false;
+}
+
 DEF_CONSOLE_CMD(ConFramerateWindow)
 {
 	if (argc == 0) {
@@ -2636,10 +2810,13 @@ void IConsoleStdLibRegister()
 #endif
 	IConsole::CmdRegister("fps",                     ConFramerate);
 	IConsole::CmdRegister("fps_wnd",                 ConFramerateWindow);
+	IConsole::CmdRegister("fps_trace",               ConFramerateTrace);
 
 	/* NewGRF development stuff */
 	IConsole::CmdRegister("reload_newgrfs",          ConNewGRFReload,     ConHookNewGRFDeveloperTool);
 	IConsole::CmdRegister("newgrf_profile",          ConNewGRFProfile,    ConHookNewGRFDeveloperTool);
 
 	IConsole::CmdRegister("dump_info",               ConDumpInfo);
+	IConsole::CmdRegister("cargo_packets",           ConCargoPackets);
+	IConsole::CmdRegister("pf_benchmark",            ConPathfinderBenchmark, ConHookServerOrNoNetwork);
 }
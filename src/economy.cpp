@@ -54,6 +54,7 @@
 #include "vehicle_cmd.h"
 #include "timer/timer.h"
 #include "timer/timer_game_calendar.h"
+#include "pathfinder/yapf/yapf_cache.h"
 
 #include "table/strings.h"
 #include "table/pricebase.h"
@@ -494,6 +495,11 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 			ChangeTileOwner(tile, old_owner, new_owner);
 		} while (++tile != Map::Size());
 
+		/* Trains can not follow track of other companies, so rail segments may now be joined. */
+		YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+		/* Neither can road vehicles use depots of other companies, so shared routes may change. */
+		YapfNotifyRoadLayoutChange(INVALID_TILE);
+
 		if (new_owner != INVALID_OWNER) {
 			/* Update all signals because there can be new segment that was owned by two companies
 			 * and signals were not propagated
@@ -1225,15 +1231,16 @@ CargoPayment::~CargoPayment()
  * Handle payment for final delivery of the given cargo packet.
  * @param cp The cargo packet to pay for.
  * @param count The number of packets to pay for.
+ * @param periods_in_transit Number of cargo aging periods the cargo has been in transit.
  */
-void CargoPayment::PayFinalDelivery(const CargoPacket *cp, uint count)
+void CargoPayment::PayFinalDelivery(const CargoPacket *cp, uint count, uint16_t periods_in_transit)
 {
 	if (this->owner == nullptr) {
 		this->owner = Company::Get(this->front->owner);
 	}
 
 	/* Handle end of route payment */
-	Money profit = DeliverGoods(count, this->ct, this->current_station, cp->SourceStationXY(), cp->PeriodsInTransit(), this->owner, cp->SourceSubsidyType(), cp->SourceSubsidyID());
+	Money profit = DeliverGoods(count, this->ct, this->current_station, cp->SourceStationXY(), periods_in_transit, this->owner, cp->SourceSubsidyType(), cp->SourceSubsidyID());
 	this->route_profit += profit;
 
 	/* The vehicle's profit is whatever route profit there is minus feeder shares. */
@@ -1244,16 +1251,17 @@ void CargoPayment::PayFinalDelivery(const CargoPacket *cp, uint count)
  * Handle payment for transfer of the given cargo packet.
  * @param cp The cargo packet to pay for; actual payment won't be made!.
  * @param count The number of packets to pay for.
+ * @param periods_in_transit Number of cargo aging periods the cargo has been in transit.
  * @return The amount of money paid for the transfer.
  */
-Money CargoPayment::PayTransfer(const CargoPacket *cp, uint count)
+Money CargoPayment::PayTransfer(const CargoPacket *cp, uint count, uint16_t periods_in_transit)
 {
 	Money profit = -cp->FeederShare(count) + GetTransportedGoodsIncome(
 			count,
 			/* pay transfer vehicle the difference between the payment for the journey from
 			 * the source to the current point, and the sum of the previous transfer payments */
 			DistanceManhattan(cp->SourceStationXY(), Station::Get(this->current_station)->xy),
-			cp->PeriodsInTransit(),
+			periods_in_transit,
 			this->ct);
 
 	profit = profit * _settings_game.economy.feeder_payment_share / 100;
@@ -1269,7 +1277,7 @@ Money CargoPayment::PayTransfer(const CargoPacket *cp, uint count)
 void PrepareUnload(Vehicle *front_v)
 {
 	Station *curr_station = Station::Get(front_v->last_station_visited);
-	curr_station->loading_vehicles.push_back(front_v);
+	curr_station->AddLoadingVehicle(front_v);
 
 	/* At this moment loading cannot be finished */
 	ClrBit(front_v->vehicle_flags, VF_LOADING_FINISHED);
@@ -1718,6 +1726,7 @@ static void LoadUnloadVehicle(Vehicle *front)
 					 * first unload to prevent the cargo from quickly decaying after the initial drop. */
 					ge->time_since_pickup = 0;
 					SetBit(ge->status, GoodsEntry::GES_RATING);
+					SetBit(st->rating_cargoes, v->cargo_type);
 				}
 			}
 
@@ -37,8 +37,8 @@ struct CargoPayment : CargoPaymentPool::PoolItem<&_cargo_payment_pool> {
 	CargoPayment(Vehicle *front);
 	~CargoPayment();
 
-	Money PayTransfer(const CargoPacket *cp, uint count);
-	void PayFinalDelivery(const CargoPacket *cp, uint count);
+	Money PayTransfer(const CargoPacket *cp, uint count, uint16_t periods_in_transit);
+	void PayFinalDelivery(const CargoPacket *cp, uint count, uint16_t periods_in_transit);
 
 	/**
 	 * Sets the currently handled cargo type.
@@ -24,11 +24,18 @@
 #include "game/game_instance.hpp"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
+#include "timer/timer_game_tick.h"
+#include "fileio_func.h"
+#include "pathfinder/yapf/yapf_cache.h"
+#include "linkgraph/linkgraphschedule.h"
+#include "3rdparty/fmt/chrono.h"
 
 #include "widgets/framerate_widget.h"
 
 #include <atomic>
 #include <mutex>
+#include <bitset>
+#include <numeric>
 
 #include "safeguards.h"
 
@@ -197,6 +204,13 @@ namespace {
 		PerformanceData(1),                     // PFE_ACC_GL_AIRCRAFT
 		PerformanceData(1),                     // PFE_GL_LANDSCAPE
 		PerformanceData(1),                     // PFE_GL_LINKGRAPH
+		PerformanceData(1),                     // PFE_GL_PF_TRAINS
+		PerformanceData(1),                     // PFE_GL_PF_ROADVEHS
+		PerformanceData(1),                     // PFE_GL_PF_SHIPS
+		PerformanceData(1),                     // PFE_GL_AUTOREPLACE
+		PerformanceData(1),                     // PFE_GL_TILELOOP
+		PerformanceData(1),                     // PFE_GL_TOWNS
+		PerformanceData(1),                     // PFE_GL_INDUSTRIES
 		PerformanceData(1000.0 / 30),           // PFE_DRAWING
 		PerformanceData(1),                     // PFE_ACC_DRAWWORLD
 		PerformanceData(60.0),                  // PFE_VIDEO
@@ -223,6 +237,43 @@ namespace {
 }
 
 
+/** A single measured block of a game loop element, as recorded for a performance trace. */
+struct PerformanceTraceEvent {
+	PerformanceElement elem;      ///< The element the block was measured for.
+	TimingMeasurement start_time; ///< Start time of the block.
+	TimingMeasurement duration;   ///< Time spent in the block.
+};
+
+/** Maximum number of events in a performance trace, so a forgotten trace can not use up all memory. */
+static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+static bool _pf_trace_active = false;    ///< Whether a performance trace is being recorded.
+static bool _pf_trace_truncated = false; ///< Whether events were dropped because the trace was full.
+static std::vector<PerformanceTraceEvent> _pf_trace_events; ///< Events of the performance trace being recorded.
+
+static bool _pf_benchmark_active = false; ///< Whether every tick of the game loop elements is being sampled for a benchmark.
+static std::vector<TimingMeasurement> _pf_benchmark_samples[PFE_MAX]; ///< Time spent per tick of each element during the benchmark.
+static std::bitset<PFE_MAX> _pf_benchmark_accumulating; ///< Accumulating elements that have been reset since the benchmark started.
+
+/**
+ * Store a measured block in the performance trace, if one is being recorded.
+ * Only elements measured on the game loop thread are traced; the drawing, video and sound elements are not.
+ * @param elem The element the block was measured for.
+ * @param start_time Start time of the block.
+ * @param end_time End time of the block.
+ */
+static void RecordTraceEvent(PerformanceElement elem, TimingMeasurement start_time, TimingMeasurement end_time)
+{
+	if (elem >= PFE_DRAWING && elem <= PFE_SOUND) return;
+	if (!_pf_trace_active) return;
+
+	if (_pf_trace_events.size() >= MAX_TRACE_EVENTS) {
+		_pf_trace_truncated = true;
+		return;
+	}
+	_pf_trace_events.push_back({elem, start_time, end_time - start_time});
+}
+
 /**
  * Return a timestamp with \c TIMESTAMP_PRECISION ticks per second precision.
  * The basis of the timestamp is implementation defined, but the value should be steady,
@@ -273,7 +324,10 @@ PerformanceMeasurer::~PerformanceMeasurer()
 		_sound_perf_pending.store(true, std::memory_order_release);
 		return;
 	}
-	_pf_data[this->elem].Add(this->start_time, GetPerformanceTimer());
+	TimingMeasurement end_time = GetPerformanceTimer();
+	_pf_data[this->elem].Add(this->start_time, end_time);
+	RecordTraceEvent(this->elem, this->start_time, end_time);
+	if (_pf_benchmark_active) _pf_benchmark_samples[this->elem].push_back(end_time - this->start_time);
 }
 
 /** Set the rate of expected cycles per second of a performance element. */
@@ -316,7 +370,9 @@ PerformanceAccumulator::PerformanceAccumulator(PerformanceElement elem)
 /** Finish and add one block of the accumulating value. */
 PerformanceAccumulator::~PerformanceAccumulator()
 {
-	_pf_data[this->elem].AddAccumulate(GetPerformanceTimer() - this->start_time);
+	TimingMeasurement end_time = GetPerformanceTimer();
+	_pf_data[this->elem].AddAccumulate(end_time - this->start_time);
+	RecordTraceEvent(this->elem, this->start_time, end_time);
 }
 
 /**
@@ -326,6 +382,11 @@ PerformanceAccumulator::~PerformanceAccumulator()
  */
 void PerformanceAccumulator::Reset(PerformanceElement elem)
 {
+	if (_pf_benchmark_active) {
+		/* The first reset finishes an accumulation from before the benchmark started. */
+		if (_pf_benchmark_accumulating[elem]) _pf_benchmark_samples[elem].push_back(_pf_data[elem].acc_duration);
+		_pf_benchmark_accumulating.set(elem);
+	}
 	_pf_data[elem].BeginAccumulate(GetPerformanceTimer());
 }
 
@@ -337,10 +398,17 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_GAMELOOP,
 	PFE_GL_ECONOMY,
 	PFE_GL_TRAINS,
+	PFE_GL_PF_TRAINS,
 	PFE_GL_ROADVEHS,
+	PFE_GL_PF_ROADVEHS,
 	PFE_GL_SHIPS,
+	PFE_GL_PF_SHIPS,
 	PFE_GL_AIRCRAFT,
+	PFE_GL_AUTOREPLACE,
 	PFE_GL_LANDSCAPE,
+	PFE_GL_TILELOOP,
+	PFE_GL_TOWNS,
+	PFE_GL_INDUSTRIES,
 	PFE_ALLSCRIPTS,
 	PFE_GAMESCRIPT,
 	PFE_AI0,
@@ -365,6 +433,31 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_SOUND,
 };
 
+/** Names of the performance elements for console and trace output, except for the AI elements. */
+static const char *MEASUREMENT_NAMES[PFE_AI0] = {
+	"Game loop",
+	"  GL station ticks",
+	"  GL train ticks",
+	"  GL road vehicle ticks",
+	"  GL ship ticks",
+	"  GL aircraft ticks",
+	"  GL landscape ticks",
+	"  GL link graph delays",
+	"    GL train pathfinding",
+	"    GL road vehicle pathfinding",
+	"    GL ship pathfinding",
+	"  GL autoreplace",
+	"    GL tile loop",
+	"    GL town ticks",
+	"    GL industry ticks",
+	"Drawing",
+	"  Viewport drawing",
+	"Video output",
+	"Sound mixing",
+	"AI/GS scripts total",
+	"Game script",
+};
+
 static const char * GetAIName(int ai_index)
 {
 	if (!Company::IsValidAiID(ai_index)) return "";
@@ -384,6 +477,8 @@ static const NWidgetPart _framerate_window_widgets[] = {
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_GAMELOOP), SetDataTip(STR_FRAMERATE_RATE_GAMELOOP, STR_FRAMERATE_RATE_GAMELOOP_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_DRAWING),  SetDataTip(STR_FRAMERATE_RATE_BLITTER,  STR_FRAMERATE_RATE_BLITTER_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_FACTOR),   SetDataTip(STR_FRAMERATE_SPEED_FACTOR,  STR_FRAMERATE_SPEED_FACTOR_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
+			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_ROAD_ROUTE_CACHE), SetDataTip(STR_FRAMERATE_ROAD_ROUTE_CACHE, STR_FRAMERATE_ROAD_ROUTE_CACHE_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
+			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_LINKGRAPH_JOBS), SetDataTip(STR_FRAMERATE_LINKGRAPH_JOBS, STR_FRAMERATE_LINKGRAPH_JOBS_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
@@ -534,6 +629,19 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				this->speed_gameloop.InsertDParams(0);
 				break;
+			case WID_FRW_ROAD_ROUTE_CACHE: {
+				YapfRoadRouteCacheStats stats = YapfGetRoadRouteCacheStats();
+				SetDParam(0, stats.hits);
+				SetDParam(1, stats.misses);
+				break;
+			}
+			case WID_FRW_LINKGRAPH_JOBS: {
+				LinkGraphSchedule::Stats stats = LinkGraphSchedule::instance.GetStats();
+				SetDParam(0, stats.calculating);
+				SetDParam(1, stats.waiting);
+				SetDParam(2, stats.queued);
+				break;
+			}
 			case WID_FRW_INFO_DATA_POINTS:
 				SetDParam(0, NUM_FRAMERATE_POINTS);
 				break;
@@ -560,6 +668,17 @@ struct FramerateWindow : Window {
 				SetDParam(1, 2);
 				*size = GetStringBoundingBox(STR_FRAMERATE_SPEED_FACTOR);
 				break;
+			case WID_FRW_ROAD_ROUTE_CACHE:
+				SetDParamMaxValue(0, 999999999);
+				SetDParamMaxValue(1, 999999999);
+				*size = GetStringBoundingBox(STR_FRAMERATE_ROAD_ROUTE_CACHE);
+				break;
+			case WID_FRW_LINKGRAPH_JOBS:
+				SetDParamMaxValue(0, 999);
+				SetDParamMaxValue(1, 999);
+				SetDParamMaxValue(2, 99999);
+				*size = GetStringBoundingBox(STR_FRAMERATE_LINKGRAPH_JOBS);
+				break;
 
 			case WID_FRW_TIMES_NAMES: {
 				size->width = 0;
@@ -1042,22 +1161,6 @@ void ConPrintFramerate()
 
 	IConsolePrint(TC_SILVER, "Based on num. data points: {} {} {}", count1, count2, count3);
 
-	static const char *MEASUREMENT_NAMES[PFE_MAX] = {
-		"Game loop",
-		"  GL station ticks",
-		"  GL train ticks",
-		"  GL road vehicle ticks",
-		"  GL ship ticks",
-		"  GL aircraft ticks",
-		"  GL landscape ticks",
-		"  GL link graph delays",
-		"Drawing",
-		"  Viewport drawing",
-		"Video output",
-		"Sound mixing",
-		"AI/GS scripts total",
-		"Game script",
-	};
 	std::string ai_name_buf;
 
 	static const PerformanceElement rate_elements[] = { PFE_GAMELOOP, PFE_DRAWING, PFE_VIDEO };
@@ -1115,3 +1218,137 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+/**
+ * Get the name of a performance element for the performance trace.
+ * @param elem The element to get the name of.
+ * @return Name of the element, without indentation.
+ */
+static std::string GetTraceElementName(PerformanceElement elem)
+{
+	if (elem >= PFE_AI0) return fmt::format("AI {}", elem - PFE_AI0 + 1);
+
+	std::string_view name = MEASUREMENT_NAMES[elem];
+	return std::string(name.substr(name.find_first_not_of(' ')));
+}
+
+/** Timer that finishes the performance trace after a given number of ticks. */
+static TimeoutTimer<TimerGameTick> _pf_trace_finish_timeout(0, []()
+{
+	FinishPerformanceTrace();
+});
+
+/**
+ * Start recording a performance trace of the game loop.
+ * @param ticks Number of game ticks after which to finish the trace automatically, 0 to record until stopped.
+ */
+void StartPerformanceTrace(uint64_t ticks)
+{
+	_pf_trace_events.clear();
+	_pf_trace_truncated = false;
+	_pf_trace_active = true;
+	IConsolePrint(CC_DEBUG, "Started recording a performance trace.");
+
+	if (ticks > 0) {
+		_pf_trace_finish_timeout.Reset(ticks);
+		IConsolePrint(CC_DEBUG, "Recording will automatically stop after {} ticks.", ticks);
+	} else {
+		_pf_trace_finish_timeout.Abort();
+	}
+}
+
+/**
+ * Stop recording the performance trace and write it to a file in the Chrome trace event format.
+ * Nested measurements show up as a call hierarchy when loaded in a trace viewer.
+ */
+void FinishPerformanceTrace()
+{
+	_pf_trace_finish_timeout.Abort();
+
+	if (!_pf_trace_active) {
+		IConsolePrint(CC_ERROR, "No performance trace is being recorded.");
+		return;
+	}
+	_pf_trace_active = false;
+
+	if (_pf_trace_events.empty()) {
+		IConsolePrint(CC_DEBUG, "Finished performance trace, no events collected, not writing a file.");
+		return;
+	}
+
+	std::string filename = fmt::format("{}tickprofile-{:%Y%m%d-%H%M%S}.json", FiosGetScreenshotDir(), fmt::localtime(time(nullptr)));
+	FILE *f = FioFOpenFile(filename, "wt", Subdirectory::NO_DIRECTORY);
+	if (f == nullptr) {
+		IConsolePrint(CC_ERROR, "Could not open '{}' for writing the performance trace.", filename);
+		AbortPerformanceTrace();
+		return;
+	}
+	FileCloser fcloser(f);
+
+	IConsolePrint(CC_DEBUG, "Finished performance trace, writing {} events to '{}'.", _pf_trace_events.size(), filename);
+	if (_pf_trace_truncated) IConsolePrint(CC_WARNING, "The trace was full, later events have been dropped.");
+
+	/* Blocks are recorded when they end, so the first one to start is not necessarily the first in the list. */
+	TimingMeasurement first_start = _pf_trace_events.front().start_time;
+	for (const PerformanceTraceEvent &ev : _pf_trace_events) first_start = std::min(first_start, ev.start_time);
+
+	std::string names[PFE_MAX];
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) names[e] = GetTraceElementName(e);
+
+	fmt::print(f, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (const PerformanceTraceEvent &ev : _pf_trace_events) {
+		fmt::print(f, "{}{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{},\"dur\":{}}}", first ? "" : ",\n", names[ev.elem], ev.start_time - first_start, ev.duration);
+		first = false;
+	}
+	fmt::print(f, "\n]}}\n");
+
+	AbortPerformanceTrace();
+}
+
+/** Stop recording the performance trace and discard all collected data. */
+void AbortPerformanceTrace()
+{
+	_pf_trace_finish_timeout.Abort();
+	_pf_trace_active = false;
+	_pf_trace_truncated = false;
+	_pf_trace_events.clear();
+	_pf_trace_events.shrink_to_fit();
+}
+
+/** Start sampling the time spent in every tick of the game loop elements, for a benchmark. */
+void StartPerformanceBenchmark()
+{
+	for (auto &samples : _pf_benchmark_samples) samples.clear();
+	_pf_benchmark_accumulating.reset();
+	_pf_benchmark_active = true;
+}
+
+/** Stop sampling for the benchmark, and print percentiles of the time spent per tick in each element to the standard output. */
+void FinishPerformanceBenchmark()
+{
+	_pf_benchmark_active = false;
+
+	/* The accumulations of the last tick are not finished by a reset. */
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		if (_pf_benchmark_accumulating[e]) _pf_benchmark_samples[e].push_back(_pf_data[e].acc_duration);
+	}
+
+	fmt::print("{:<32} {:>8} {:>9} {:>9} {:>9} {:>9} {:>9}\n", "Element (ms/tick)", "Ticks", "Mean", "50%", "90%", "99%", "Max");
+	for (PerformanceElement e : DISPLAY_ORDER_PFE) {
+		std::vector<TimingMeasurement> &samples = _pf_benchmark_samples[e];
+		if (samples.empty()) continue;
+
+		std::sort(samples.begin(), samples.end());
+		auto percentile = [&samples](uint p) -> double {
+			return (double)samples[(samples.size() - 1) * p / 100] * 1000 / TIMESTAMP_PRECISION;
+		};
+		TimingMeasurement total = std::accumulate(samples.begin(), samples.end(), (TimingMeasurement)0);
+		double mean = (double)total * 1000 / TIMESTAMP_PRECISION / samples.size();
+
+		std::string name = e < PFE_AI0 ? MEASUREMENT_NAMES[e] : fmt::format("AI {} {}", e - PFE_AI0 + 1, GetAIName(e - PFE_AI0));
+		fmt::print("{:<32} {:>8} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}\n", name, samples.size(), mean, percentile(50), percentile(90), percentile(99), percentile(100));
+		samples.clear();
+		samples.shrink_to_fit();
+	}
+}
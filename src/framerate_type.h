@@ -18,7 +18,7 @@
  * Second is adding a member to the \link anonymous_namespace{framerate_gui.cpp}::_pf_data _pf_data \endlink array, in the same position as the new #PerformanceElement member.
  *
  * @par
- * Third is adding strings for the new element. There is an array in #ConPrintFramerate with strings used for the console command.
+ * Third is adding strings for the new element. There is an array in framerate_gui.cpp with strings used for the console command and trace output.
  * Additionally, there are two sets of strings in \c english.txt for two GUI uses, also in the #PerformanceElement order.
  * Search for \c STR_FRAMERATE_GAMELOOP and \c STR_FRAMETIME_CAPTION_GAMELOOP in \c english.txt to find those.
  *
@@ -28,6 +28,12 @@
  * Use either the PerformanceMeasurer or the PerformanceAccumulator class respectively for the two cases.
  * Either class is used by instantiating an object of it at the beginning of the block to be measured, so it auto-destructs at the end of the block.
  * For PerformanceAccumulator, make sure to also call PerformanceAccumulator::Reset once at the beginning of a new frame. Usually the StateGameLoop function is appropriate for this.
+ * Measurements may be nested, e.g. the pathfinder elements are measured inside the vehicle tick elements. They are shown as children
+ * of their parent element in the GUI, see \c DISPLAY_ORDER_PFE.
+ *
+ * @par Tracing
+ * While a trace is being recorded with the \c fps_trace console command, every block of a game loop element is also stored with its
+ * start time and duration. The trace is written in the Chrome trace event format, where nested blocks show up as a call hierarchy.
  *
  * @see framerate_gui.cpp for implementation
  */
@@ -54,6 +60,13 @@ enum PerformanceElement {
 	PFE_GL_AIRCRAFT,   ///< Time spent processing aircraft
 	PFE_GL_LANDSCAPE,  ///< Time spent processing other world features
 	PFE_GL_LINKGRAPH,  ///< Time spent waiting for link graph background jobs
+	PFE_GL_PF_TRAINS,  ///< Time spent in the pathfinder choosing tracks for trains
+	PFE_GL_PF_ROADVEHS, ///< Time spent in the pathfinder choosing routes for road vehicles
+	PFE_GL_PF_SHIPS,   ///< Time spent in the pathfinder choosing tracks for ships
+	PFE_GL_AUTOREPLACE, ///< Time spent autoreplacing and autorenewing vehicles
+	PFE_GL_TILELOOP,   ///< Time spent in the periodic tile loop
+	PFE_GL_TOWNS,      ///< Time spent processing towns
+	PFE_GL_INDUSTRIES, ///< Time spent processing industries
 	PFE_DRAWING,       ///< Speed of drawing world and GUI.
 	PFE_DRAWWORLD,     ///< Time spent drawing world viewports in GUI
 	PFE_VIDEO,         ///< Speed of painting drawn video buffer.
@@ -123,4 +136,11 @@ public:
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
 
+void StartPerformanceTrace(uint64_t ticks);
+void FinishPerformanceTrace();
+void AbortPerformanceTrace();
+
+void StartPerformanceBenchmark();
+void FinishPerformanceBenchmark();
+
 #endif /* FRAMERATE_TYPE_H */
@@ -43,6 +43,7 @@
 #include "industry_cmd.h"
 #include "landscape_cmd.h"
 #include "terraform_cmd.h"
+#include "framerate_type.h"
 #include "timer/timer.h"
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_tick.h"
@@ -1199,6 +1200,8 @@ static void ProduceIndustryGoods(Industry *i)
 
 void OnTick_Industry()
 {
+	PerformanceAccumulator framerate(PFE_GL_INDUSTRIES);
+
 	if (_industry_sound_ctr != 0) {
 		_industry_sound_ctr++;
 
@@ -60,7 +60,7 @@ void LinkGraphJob::EraseFlows(NodeID from)
  */
 void LinkGraphJob::SpawnThread()
 {
-	if (!StartNewThread(&this->thread, "ottd:linkgraph", &(LinkGraphSchedule::Run), this)) {
+	if (!StartNewThread(&this->thread, "ottd:linkgraph", &(LinkGraphSchedule::RunThread), this)) {
 		/* Of course this will hang a bit.
 		 * On the other hand, if you want to play games which make this hang noticeably
 		 * on a platform without threads then you'll probably get other problems first.
@@ -28,58 +28,160 @@
 /* static */ LinkGraphSchedule LinkGraphSchedule::instance;
 
 /**
- * Start the next job in the schedule.
+ * Estimate how much work calculating a link graph is. Demands are calculated
+ * between all pairs of nodes, and the MCF passes search paths over all edges
+ * from every node.
+ * @param lg The link graph.
+ * @return The estimate, in no particular unit.
+ */
+/* static */ uint64_t LinkGraphSchedule::EstimateCost(const LinkGraph &lg)
+{
+	uint64_t edges = 0;
+	for (NodeID node = 0; node < lg.Size(); ++node) edges += lg[node].edges.size();
+	return static_cast<uint64_t>(lg.Size()) * (lg.Size() + edges);
+}
+
+/**
+ * Get the number of jobs that may calculate at the same time. The game
+ * itself keeps one hardware thread busy.
+ * @return Number of slots for calculating jobs.
+ */
+/* static */ uint LinkGraphSchedule::GetNumSlots()
+{
+	static const uint slots = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+	return slots;
+}
+
+/**
+ * Start the next jobs in the schedule. The next link graph with at least two
+ * nodes is always spawned. Further link graphs are spawned along with it as
+ * long as their estimated costs add up to no more than the first one's, or
+ * #MIN_SPAWN_COST if that is more, so small components don't each wait for a
+ * turn of their own. This only depends on the link graphs, so all clients
+ * spawn the same jobs with the same join dates.
  */
 void LinkGraphSchedule::SpawnNext()
 {
-	if (this->schedule.empty()) return;
-	LinkGraph *next = this->schedule.front();
-	LinkGraph *first = next;
-	while (next->Size() < 2) {
-		this->schedule.splice(this->schedule.end(), this->schedule, this->schedule.begin());
-		next = this->schedule.front();
-		if (next == first) return;
-	}
-	assert(next == LinkGraph::Get(next->index));
-	this->schedule.pop_front();
-	if (LinkGraphJob::CanAllocateItem()) {
-		LinkGraphJob *job = new LinkGraphJob(*next);
-		job->SpawnThread();
-		this->running.push_back(job);
-	} else {
-		NOT_REACHED();
+	uint64_t budget = 0;
+	for (uint spawned = 0; spawned < MAX_SPAWN_JOBS; ++spawned) {
+		if (this->schedule.empty()) return;
+		LinkGraph *next = this->schedule.front();
+		LinkGraph *first = next;
+		while (next->Size() < 2) {
+			this->schedule.splice(this->schedule.end(), this->schedule, this->schedule.begin());
+			next = this->schedule.front();
+			if (next == first) return;
+		}
+		assert(next == LinkGraph::Get(next->index));
+
+		uint64_t cost = EstimateCost(*next);
+		if (spawned == 0) {
+			budget = std::max(cost, MIN_SPAWN_COST);
+		} else if (cost > budget) {
+			return;
+		}
+		budget -= cost;
+
+		this->schedule.pop_front();
+		if (LinkGraphJob::CanAllocateItem()) {
+			LinkGraphJob *job = new LinkGraphJob(*next);
+			job->SpawnThread();
+			this->running.push_back(job);
+		} else {
+			NOT_REACHED();
+		}
 	}
 }
 
 /**
- * Check if the next job is supposed to be finished, but has not yet completed.
- * @return True if job should be finished by now but is still running, false if not.
+ * Check if any of the jobs that are supposed to be finished has not yet completed.
+ * @return True if a job should be finished by now but is still running, false if not.
  */
 bool LinkGraphSchedule::IsJoinWithUnfinishedJobDue() const
 {
-	if (this->running.empty()) return false;
-	const LinkGraphJob *next = this->running.front();
-	return next->IsScheduledToBeJoined() && !next->IsJobCompleted();
+	for (const LinkGraphJob *job : this->running) {
+		if (!job->IsScheduledToBeJoined()) return false;
+		if (!job->IsJobCompleted()) return true;
+	}
+	return false;
 }
 
 /**
- * Join the next finished job, if available.
+ * Join all jobs that are supposed to be finished. Jobs are joined in the order
+ * they were spawned, which is also the order of their join dates.
  */
 void LinkGraphSchedule::JoinNext()
 {
-	if (this->running.empty()) return;
-	LinkGraphJob *next = this->running.front();
-	if (!next->IsScheduledToBeJoined()) return;
-	this->running.pop_front();
-	LinkGraphID id = next->LinkGraphIndex();
-	delete next; // implicitly joins the thread
-	if (LinkGraph::IsValidID(id)) {
-		LinkGraph *lg = LinkGraph::Get(id);
-		this->Unqueue(lg); // Unqueue to avoid double-queueing recycled IDs.
-		this->Queue(lg);
+	while (!this->running.empty()) {
+		LinkGraphJob *next = this->running.front();
+		if (!next->IsScheduledToBeJoined()) return;
+		this->running.pop_front();
+		LinkGraphID id = next->LinkGraphIndex();
+		delete next; // implicitly joins the thread
+		if (LinkGraph::IsValidID(id)) {
+			LinkGraph *lg = LinkGraph::Get(id);
+			this->Unqueue(lg); // Unqueue to avoid double-queueing recycled IDs.
+			this->Queue(lg);
+		}
 	}
 }
 
+/**
+ * Wait until a job may start calculating. Free slots go to the jobs with the
+ * earliest join date, and among those to the most expensive ones first, as
+ * those are the most likely to delay their join. Neither the order nor the
+ * number of slots changes what the jobs calculate.
+ * @param job The job.
+ * @return False if the job has been aborted meanwhile.
+ */
+bool LinkGraphSchedule::AcquireSlot(const LinkGraphJob *job)
+{
+	WaitingJob waiting_job{ job, job->JoinDate(), EstimateCost(job->Graph()) };
+	auto is_before = [](const WaitingJob &a, const WaitingJob &b) {
+		if (a.join_date != b.join_date) return a.join_date < b.join_date;
+		return a.cost > b.cost;
+	};
+
+	std::unique_lock<std::mutex> guard(this->slot_lock);
+	this->waiting.insert(std::upper_bound(this->waiting.begin(), this->waiting.end(), waiting_job, is_before), waiting_job);
+	this->slot_cv.wait(guard, [&]() {
+		return job->IsJobAborted() || (this->waiting.front().job == job && this->busy_slots < GetNumSlots());
+	});
+
+	this->waiting.erase(std::find_if(this->waiting.begin(), this->waiting.end(), [job](const WaitingJob &w) { return w.job == job; }));
+	if (job->IsJobAborted()) {
+		this->slot_cv.notify_all();
+		return false;
+	}
+	this->busy_slots++;
+	/* There may be more free slots for the next job. */
+	this->slot_cv.notify_all();
+	return true;
+}
+
+/**
+ * Free the slot of a job that has finished calculating.
+ */
+void LinkGraphSchedule::ReleaseSlot()
+{
+	{
+		std::lock_guard<std::mutex> guard(this->slot_lock);
+		assert(this->busy_slots > 0);
+		this->busy_slots--;
+	}
+	this->slot_cv.notify_all();
+}
+
+/**
+ * Get what the jobs of the schedule are doing.
+ * @return The numbers of calculating, waiting and queued jobs.
+ */
+LinkGraphSchedule::Stats LinkGraphSchedule::GetStats()
+{
+	std::lock_guard<std::mutex> guard(this->slot_lock);
+	return { this->busy_slots, static_cast<uint>(this->waiting.size()), static_cast<uint>(this->schedule.size()) };
+}
+
 /**
  * Run all handlers for the given Job.
  * @param job Pointer to a link graph job.
@@ -104,6 +206,17 @@ void LinkGraphSchedule::JoinNext()
 	job->job_completed.store(true, std::memory_order_release);
 }
 
+/**
+ * Run a job on its own thread, as soon as it gets a slot.
+ * @param job Pointer to a link graph job.
+ */
+/* static */ void LinkGraphSchedule::RunThread(LinkGraphJob *job)
+{
+	if (!instance.AcquireSlot(job)) return;
+	Run(job);
+	instance.ReleaseSlot();
+}
+
 /**
  * Start all threads in the running list. This is only useful for save/load.
  * Usually threads are started when the job is created.
@@ -123,6 +236,11 @@ void LinkGraphSchedule::SpawnAll()
 	for (auto &it : instance.running) {
 		it->AbortJob();
 	}
+	/* Wake up the threads of aborted jobs that wait for a slot. */
+	{
+		std::lock_guard<std::mutex> guard(instance.slot_lock);
+	}
+	instance.slot_cv.notify_all();
 	instance.running.clear();
 	instance.schedule.clear();
 }
@@ -11,6 +11,8 @@
 #define LINKGRAPHSCHEDULE_H
 
 #include "linkgraph.h"
+#include <condition_variable>
+#include <mutex>
 
 class LinkGraphJob;
 
@@ -46,12 +48,39 @@ protected:
 	GraphList schedule;            ///< Queue for new jobs.
 	JobList running;               ///< Currently running jobs.
 
+	/** Job whose thread waits for a slot. */
+	struct WaitingJob {
+		const LinkGraphJob *job;           ///< The job.
+		TimerGameCalendar::Date join_date; ///< Date when the job is to be joined.
+		uint64_t cost;                     ///< Estimated cost of the job.
+	};
+
+	std::mutex slot_lock;               ///< Lock for the members below, which are shared with the job threads.
+	std::condition_variable slot_cv;    ///< Signalled when a job leaves its slot or jobs are aborted.
+	uint busy_slots = 0;                ///< Number of jobs calculating.
+	std::vector<WaitingJob> waiting;    ///< Jobs whose thread waits for a slot, the next one to get a slot first.
+
+	bool AcquireSlot(const LinkGraphJob *job);
+	void ReleaseSlot();
+
 public:
 	/* This is a tick where not much else is happening, so a small lag might go unnoticed. */
 	static const uint SPAWN_JOIN_TICK = 21; ///< Tick when jobs are spawned or joined every day.
+	static const uint MAX_SPAWN_JOBS = 8;   ///< Maximum number of jobs spawned at once.
+	static const uint64_t MIN_SPAWN_COST = 1 << 16; ///< Estimated cost small jobs spawned at once may add up to, if the first job is smaller.
 	static LinkGraphSchedule instance;
 
+	/** What the jobs of the schedule are doing. */
+	struct Stats {
+		uint calculating; ///< Number of jobs calculating.
+		uint waiting;     ///< Number of spawned jobs waiting for a slot.
+		uint queued;      ///< Number of link graphs waiting to be spawned.
+	};
+
+	static uint64_t EstimateCost(const LinkGraph &lg);
+	static uint GetNumSlots();
 	static void Run(LinkGraphJob *job);
+	static void RunThread(LinkGraphJob *job);
 	static void Clear();
 
 	void SpawnNext();
@@ -59,6 +88,7 @@ public:
 	void JoinNext();
 	void SpawnAll();
 	void ShiftDates(int interval);
+	Stats GetStats();
 
 	/**
 	 * Queue a link graph for execution.
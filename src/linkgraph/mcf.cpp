@@ -2,12 +2,18 @@
 
 #include "../stdafx.h"
 #include "../core/math_func.hpp"
+#include "../thread_pool.h"
 #include "mcf.h"
+#include <mutex>
 
 #include "../safeguards.h"
 
 typedef std::map<NodeID, Path *> PathViaMap;
 
+uint _linkgraph_threads; ///< Number of extra threads searching paths for link graph jobs; 0 searches on the job's thread only.
+static ThreadPool _mcf_pool("ottd:mcf"); ///< Threads searching paths for link graph jobs.
+static std::mutex _mcf_pool_lock;        ///< Lock for #_mcf_pool, as only one job at a time can run batches on it.
+
 /**
  * Distance-based annotation for use in the Dijkstra algorithm. This is close
  * to the original meaning of "annotation" in this context. Paths are rated
@@ -304,6 +310,32 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 	}
 }
 
+/**
+ * Run the Dijkstra algorithm for several sources. The searches only read the
+ * job, so they run in parallel on the MCF threads, unless another job is
+ * using those. Either way the paths from each source end up in the same place.
+ * @tparam Tannotation Annotation to be used.
+ * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
+ * @param sources Nodes where the searches start.
+ * @param paths Containers for the paths to be calculated, one per source.
+ */
+template<class Tannotation, class Tedge_iterator>
+void MultiCommodityFlow::FindPaths(const std::vector<NodeID> &sources, std::vector<PathVector> &paths)
+{
+	if (paths.size() < sources.size()) paths.resize(sources.size());
+	auto search = [&](size_t index) {
+		this->Dijkstra<Tannotation, Tedge_iterator>(sources[index], paths[index]);
+	};
+
+	std::unique_lock<std::mutex> lock(_mcf_pool_lock, std::try_to_lock);
+	if (lock.owns_lock()) {
+		_mcf_pool.Resize(_linkgraph_threads);
+		_mcf_pool.RunBatch(sources.size(), search);
+	} else {
+		for (size_t i = 0; i < sources.size(); ++i) search(i);
+	}
+}
+
 /**
  * Clean up paths that lead nowhere and the root path.
  * @param source_id ID of the root node.
@@ -493,12 +525,31 @@ bool MCF1stPass::EliminateCycles()
 }
 
 /**
- * Run the first pass of the MCF calculation.
+ * Collect the sources of a batch whose demand has not been satisfied yet.
+ * @param first First node of the batch.
+ * @param size Number of nodes of the job.
+ * @param finished_sources Sources whose demand has been satisfied.
+ * @param sources Container for the sources.
+ */
+static void GetBatchSources(uint first, uint size, const std::vector<bool> &finished_sources, std::vector<NodeID> &sources)
+{
+	sources.clear();
+	for (uint source = first; source < size && source < first + MCF_SOURCES_PER_BATCH; ++source) {
+		if (!finished_sources[source]) sources.push_back(source);
+	}
+}
+
+/**
+ * Run the first pass of the MCF calculation. The shortest paths from a batch
+ * of sources are searched first, then flow is pushed along them source by
+ * source. Pushing flow checks the edges' current capacities again, so paths
+ * that became saturated by an earlier source of the batch are not overloaded.
  * @param job Link graph job to calculate.
  */
 MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
-	PathVector paths;
+	std::vector<PathVector> batch_paths;
+	std::vector<NodeID> sources;
 	uint16_t size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool more_loops;
@@ -506,73 +557,83 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 
 	do {
 		more_loops = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
+		for (uint first = 0; first < size; first += MCF_SOURCES_PER_BATCH) {
+			GetBatchSources(first, size, finished_sources, sources);
 
 			/* First saturate the shortest paths. */
-			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(source, paths);
-
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-					Path *path = paths[dest];
-					assert(path != nullptr);
-					/* Generally only allow paths that don't exceed the
-					 * available capacity. But if no demand has been assigned
-					 * yet, make an exception and allow any valid path *once*. */
-					if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
-							accuracy, this->max_saturation) > 0) {
-						/* If a path has been found there is a chance we can
-						 * find more. */
-						more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
-					} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
-							path->GetFreeCapacity() > INT_MIN) {
-						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+			this->FindPaths<DistanceAnnotation, GraphEdgeIterator>(sources, batch_paths);
+
+			for (size_t i = 0; i < sources.size(); ++i) {
+				NodeID source = sources[i];
+				PathVector &paths = batch_paths[i];
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+						Path *path = paths[dest];
+						assert(path != nullptr);
+						/* Generally only allow paths that don't exceed the
+						 * available capacity. But if no demand has been assigned
+						 * yet, make an exception and allow any valid path *once*. */
+						if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
+								accuracy, this->max_saturation) > 0) {
+							/* If a path has been found there is a chance we can
+							 * find more. */
+							more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
+						} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
+								path->GetFreeCapacity() > INT_MIN) {
+							this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						}
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 					}
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	} while ((more_loops || this->EliminateCycles()) && !job.IsJobAborted());
 }
 
 /**
  * Run the second pass of the MCF calculation which assigns all remaining
- * demands to existing paths.
+ * demands to existing paths. Like the first pass it searches the paths from
+ * a batch of sources at once.
  * @param job Link graph job to calculate.
  */
 MCF2ndPass::MCF2ndPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
 	this->max_saturation = UINT_MAX; // disable artificial cap on saturation
-	PathVector paths;
+	std::vector<PathVector> batch_paths;
+	std::vector<NodeID> sources;
 	uint16_t size = job.Size();
 	uint accuracy = job.Settings().accuracy;
 	bool demand_left = true;
 	std::vector<bool> finished_sources(size);
 	while (demand_left && !job.IsJobAborted()) {
 		demand_left = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
+		for (uint first = 0; first < size; first += MCF_SOURCES_PER_BATCH) {
+			GetBatchSources(first, size, finished_sources, sources);
 
-			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(source, paths);
+			this->FindPaths<CapacityAnnotation, FlowEdgeIterator>(sources, batch_paths);
 
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				Path *path = paths[dest];
-				if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
-					this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-						demand_left = true;
-						source_demand_left = true;
+			for (size_t i = 0; i < sources.size(); ++i) {
+				NodeID source = sources[i];
+				PathVector &paths = batch_paths[i];
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					Path *path = paths[dest];
+					if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
+						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+							demand_left = true;
+							source_demand_left = true;
+						}
 					}
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	}
 }
@@ -7,6 +7,15 @@
 
 typedef std::vector<Path *> PathVector;
 
+extern uint _linkgraph_threads;
+
+/**
+ * Number of sources whose paths are searched at once, on several threads,
+ * before flow is pushed along any of them. This must not depend on the number
+ * of threads, so that all clients calculate the same flows.
+ */
+static const uint MCF_SOURCES_PER_BATCH = 32;
+
 /**
  * Multi-commodity flow calculating base class.
  */
@@ -23,6 +32,9 @@ protected:
 	template<class Tannotation, class Tedge_iterator>
 	void Dijkstra(NodeID from, PathVector &paths);
 
+	template<class Tannotation, class Tedge_iterator>
+	void FindPaths(const std::vector<NodeID> &sources, std::vector<PathVector> &paths);
+
 	uint PushFlow(Node &node, NodeID to, Path *path, uint accuracy, uint max_saturation);
 
 	void CleanupPaths(NodeID source, PathVector &paths);
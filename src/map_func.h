@@ -198,6 +198,18 @@ public:
 	{
 		return extended_tiles[tile].m8;
 	}
+
+	/**
+	 * Hint the processor to start loading the map data of this tile into the cache.
+	 * Useful when tiles are visited in an order that hardware prefetching cannot predict.
+	 */
+	debug_inline void Prefetch() const
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(&base_tiles[tile]);
+		__builtin_prefetch(&extended_tiles[tile]);
+#endif
+	}
 };
 
 /**
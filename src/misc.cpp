@@ -56,6 +56,10 @@ void InitializeTrees();
 void InitializeCompanies();
 void InitializeCheats();
 void InitializeNPF();
+void InitializeRoadRouteCache();
+void InitializeShipRouteCache();
+void InitializeYapfLandmarks();
+void InitializeYapfJunctionGraph();
 void InitializeOldNames();
 
 /**
@@ -144,6 +148,10 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	InitializeBuildingCounts();
 
 	InitializeNPF();
+	InitializeRoadRouteCache();
+	InitializeShipRouteCache();
+	InitializeYapfLandmarks();
+	InitializeYapfJunctionGraph();
 
 	InitializeCompanies();
 	AI::Initialize();
@@ -11,6 +11,8 @@
 #define HASHTABLE_HPP
 
 #include "../core/math_func.hpp"
+#include "../core/bitmath_func.hpp"
+#include "../core/endian_type.hpp"
 
 template <class Titem_>
 struct CHashTableSlotT
@@ -254,4 +256,205 @@ public:
 	}
 };
 
+/**
+ * class COpenHashTableT<Tkey, Tvalue> - hash table with open addressing
+ *  that stores a value for every key it has been given.
+ *
+ *  Keys can only be added, not removed, and clearing the table keeps its
+ *  memory for the next use. This makes it fit for the lists of a search that
+ *  are reset between searches.
+ *
+ *  The slots are probed in groups of eight. Each slot has a control byte that
+ *  is zero when the slot is free, and otherwise holds seven bits of the hash
+ *  of its key with the highest bit set. The eight control bytes of a group are
+ *  compared with the hash of the wanted key at once, as one 64 bit word, so a
+ *  search rarely compares more than one key.
+ *
+ *  Tkey must support CalcHash() and operator== like the keys of CHashTableT,
+ *  and Tkey and Tvalue must be default constructible.
+ */
+template <class Tkey, class Tvalue>
+class COpenHashTableT {
+protected:
+	static constexpr uint GROUP_SIZE = 8;                        ///< Number of slots probed at once.
+	static constexpr uint MIN_GROUPS = 2;                        ///< Least number of groups of the table.
+	static constexpr uint64_t LOW_BITS = 0x0101010101010101ULL;  ///< Lowest bit of every control byte in a group.
+	static constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL; ///< Highest bit of every control byte in a group.
+
+	/** A key and its value. */
+	struct Slot {
+		Tkey key;     ///< The key.
+		Tvalue value; ///< Its value.
+	};
+
+	std::vector<uint8_t> m_ctrl; ///< Control byte of each slot.
+	std::vector<Slot> m_slots;   ///< The slots.
+	uint m_group_bits = 0;       ///< Number of groups as power of two.
+	uint m_num_items = 0;        ///< Number of used slots.
+
+	/** Spread the hash of a key over all 64 bits. */
+	inline static uint64_t CalcHash(const Tkey &key)
+	{
+		return static_cast<uint32_t>(key.CalcHash()) * 0x9E3779B97F4A7C15ULL;
+	}
+
+	/** Control byte of a used slot for the given hash. */
+	inline static uint8_t CalcTag(uint64_t hash)
+	{
+		return 0x80 | ((hash >> 32) & 0x7F);
+	}
+
+	/** Bytes of a group equal to the given control byte; may also mark some bytes after the first match. */
+	inline static uint64_t MatchTag(uint64_t group, uint8_t tag)
+	{
+		uint64_t x = group ^ (LOW_BITS * tag);
+		return (x - LOW_BITS) & ~x & HIGH_BITS;
+	}
+
+	/** Free bytes of a group. */
+	inline static uint64_t MatchFree(uint64_t group)
+	{
+		return ~group & HIGH_BITS;
+	}
+
+	/** Index within its group of the first byte marked in a match. */
+	inline static uint FirstMatch(uint64_t match)
+	{
+#if TTD_ENDIAN == TTD_BIG_ENDIAN
+		return GROUP_SIZE - 1 - FindLastBit(match) / 8;
+#else
+		return FindFirstBit(match) / 8;
+#endif
+	}
+
+	/** Remove the first byte marked in a match. */
+	inline static uint64_t NextMatch(uint64_t match)
+	{
+#if TTD_ENDIAN == TTD_BIG_ENDIAN
+		return ClrBit(match, FindLastBit(match));
+#else
+		return KillFirstBit(match);
+#endif
+	}
+
+	/** Control bytes of a group. */
+	inline uint64_t LoadGroup(uint group) const
+	{
+		uint64_t bytes;
+		memcpy(&bytes, &m_ctrl[group * GROUP_SIZE], sizeof(bytes));
+		return bytes;
+	}
+
+	/** Number of slots. */
+	inline uint Capacity() const
+	{
+		return static_cast<uint>(m_ctrl.size());
+	}
+
+	/** Index of a free slot for a key with the given hash, which must not be in the table. */
+	uint FindFreeSlot(uint64_t hash) const
+	{
+		uint mask = (1 << m_group_bits) - 1;
+		uint group = static_cast<uint>(hash >> (64 - m_group_bits));
+		for (uint step = 1;; step++) {
+			uint64_t match = MatchFree(LoadGroup(group));
+			if (match != 0) return group * GROUP_SIZE + FirstMatch(match);
+			group = (group + step) & mask;
+		}
+	}
+
+	/** Make room for the given number of groups, and insert all keys again. */
+	void Resize(uint group_bits)
+	{
+		std::vector<uint8_t> ctrl(GROUP_SIZE << group_bits, 0);
+		std::vector<Slot> slots(GROUP_SIZE << group_bits);
+		std::swap(ctrl, m_ctrl);
+		std::swap(slots, m_slots);
+		m_group_bits = group_bits;
+		for (size_t i = 0; i < ctrl.size(); i++) {
+			if (ctrl[i] == 0) continue;
+			uint slot = FindFreeSlot(CalcHash(slots[i].key));
+			m_ctrl[slot] = ctrl[i];
+			m_slots[slot] = std::move(slots[i]);
+		}
+	}
+
+public:
+	/**
+	 * Create a hash table.
+	 * @param min_capacity Number of slots to start with.
+	 */
+	explicit COpenHashTableT(uint min_capacity = 0)
+	{
+		uint group_bits = FindLastBit(MIN_GROUPS);
+		while ((GROUP_SIZE << group_bits) < min_capacity) group_bits++;
+		Resize(group_bits);
+	}
+
+	/** item count */
+	inline uint Count() const
+	{
+		return m_num_items;
+	}
+
+	/** forget all items, but keep the memory */
+	inline void Clear()
+	{
+		std::fill(m_ctrl.begin(), m_ctrl.end(), 0);
+		m_num_items = 0;
+	}
+
+	/**
+	 * Forget all items, and give back memory when there are more slots than wanted.
+	 * @param max_capacity The most slots to keep.
+	 */
+	void Shrink(uint max_capacity)
+	{
+		if (Capacity() > max_capacity) {
+			m_ctrl.clear();
+			m_slots.clear();
+			m_group_bits = 0;
+			Resize(FindLastBit(std::max<uint>(max_capacity / GROUP_SIZE, MIN_GROUPS)));
+		}
+		Clear();
+	}
+
+	/** value search; nullptr when the key is not in the table */
+	Tvalue *Find(const Tkey &key)
+	{
+		uint64_t hash = CalcHash(key);
+		uint8_t tag = CalcTag(hash);
+		uint mask = (1 << m_group_bits) - 1;
+		uint group = static_cast<uint>(hash >> (64 - m_group_bits));
+		for (uint step = 1;; step++) {
+			uint64_t bytes = LoadGroup(group);
+			for (uint64_t match = MatchTag(bytes, tag); match != 0; match = NextMatch(match)) {
+				Slot &slot = m_slots[group * GROUP_SIZE + FirstMatch(match)];
+				if (slot.key == key) return &slot.value;
+			}
+			/* Keys are never removed, so probing ends at the first group with a free slot. */
+			if (MatchFree(bytes) != 0) return nullptr;
+			group = (group + step) & mask;
+		}
+	}
+
+	/** value search; adds the key with a default value when it is not in the table yet */
+	Tvalue &FindOrInsert(const Tkey &key)
+	{
+		Tvalue *value = Find(key);
+		if (value != nullptr) return *value;
+
+		/* Keep at least one slot in eight free. */
+		if ((m_num_items + 1) * GROUP_SIZE > Capacity() * (GROUP_SIZE - 1)) Resize(m_group_bits + 1);
+
+		uint64_t hash = CalcHash(key);
+		uint index = FindFreeSlot(hash);
+		m_ctrl[index] = CalcTag(hash);
+		m_slots[index].key = key;
+		m_slots[index].value = Tvalue();
+		m_num_items++;
+		return m_slots[index].value;
+	}
+};
+
 #endif /* HASHTABLE_HPP */
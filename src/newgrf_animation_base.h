@@ -59,7 +59,9 @@ struct AnimationBase {
 		/* An animation speed of 2 means the animation frame changes 4 ticks, and
 		 * increasing this value by one doubles the wait. 0 is the minimum value
 		 * allowed for animation_speed, which corresponds to 30ms, and 16 is the
-		 * maximum, corresponding to around 33 minutes. */
+		 * maximum, corresponding to around 33 minutes. The animated tile list
+		 * uses the speed to skip the tile on ticks where nothing can change. */
+		SetAnimatedTileSpeed(tile, animation_speed);
 		if (TimerGameTick::counter % (1ULL << animation_speed) != 0) return;
 
 		uint8_t frame      = Tframehelper::Get(obj, tile);
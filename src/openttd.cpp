@@ -76,6 +76,9 @@
 #include "timer/timer_game_tick.h"
 
 #include "linkgraph/linkgraphschedule.h"
+#include "pathfinder/track_status_cache.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/yapf/yapf_landmarks.h"
 
 #include <system_error>
 
@@ -183,6 +186,8 @@ static void ShowHelp()
 		"  -q savegame         = Write some information about the savegame and exit\n"
 		"  -Q                  = Don't scan for/load NewGRF files on startup\n"
 		"  -QQ                 = Disable NewGRF scanning/loading entirely\n"
+		"  -B savegame         = Run a benchmark on savegame and exit\n"
+		"  --ticks ticks       = Number of ticks to run the benchmark for (default 1000)\n"
 		"\n";
 
 	/* List the graphics packs */
@@ -463,6 +468,25 @@ struct AfterNewGRFScan : NewGRFScanCallback {
 extern void DedicatedFork();
 #endif
 
+/**
+ * Set the savegame or scenario to load when the game starts.
+ * @param name Name of the file to load.
+ */
+static void SetStartupSavegame(const char *name)
+{
+	_file_to_saveload.name = name;
+	bool is_scenario = _switch_mode == SM_EDITOR || _switch_mode == SM_LOAD_SCENARIO;
+	_switch_mode = is_scenario ? SM_LOAD_SCENARIO : SM_LOAD_GAME;
+	_file_to_saveload.SetMode(SLO_LOAD, is_scenario ? FT_SCENARIO : FT_SAVEGAME, DFT_GAME_FILE);
+
+	/* if the file doesn't exist or it is not a valid savegame, let the saveload code show an error */
+	auto t = _file_to_saveload.name.find_last_of('.');
+	if (t != std::string::npos) {
+		auto [ft, _] = FiosGetSavegameListCallback(SLO_LOAD, _file_to_saveload.name, _file_to_saveload.name.substr(t));
+		if (ft != FIOS_TYPE_INVALID) _file_to_saveload.SetMode(ft);
+	}
+}
+
 /** Options of OpenTTD. */
 static const OptionData _options[] = {
 	 GETOPT_SHORT_VALUE('I'),
@@ -492,6 +516,8 @@ static const OptionData _options[] = {
 	 GETOPT_SHORT_VALUE('q'),
 	 GETOPT_SHORT_NOVAL('h'),
 	 GETOPT_SHORT_NOVAL('Q'),
+	 GETOPT_SHORT_VALUE('B'),
+	GETOPT_GENERAL('T', '\0', "--ticks", ODF_HAS_VALUE),
 	GETOPT_END()
 };
 
@@ -515,6 +541,8 @@ int openttd_main(int argc, char *argv[])
 	bool dedicated = false;
 	char *debuglog_conn = nullptr;
 	bool only_local_path = false;
+	bool benchmark = false;
+	uint benchmark_ticks = 1000;
 
 	extern bool _dedicated_forks;
 	_dedicated_forks = false;
@@ -547,6 +575,14 @@ int openttd_main(int argc, char *argv[])
 			}
 			break;
 		case 'f': _dedicated_forks = true; break;
+		case 'B':
+			musicdriver = "null";
+			sounddriver = "null";
+			blitter = "null";
+			benchmark = true;
+			SetStartupSavegame(mgo.opt);
+			break;
+		case 'T': benchmark_ticks = std::strtoul(mgo.opt, nullptr, 10); break;
 		case 'n':
 			scanner->connection_string = mgo.opt; // optional IP:port#company parameter
 			break;
@@ -571,18 +607,7 @@ int openttd_main(int argc, char *argv[])
 		case 'e': _switch_mode = (_switch_mode == SM_LOAD_GAME || _switch_mode == SM_LOAD_SCENARIO ? SM_LOAD_SCENARIO : SM_EDITOR); break;
 		case 'g':
 			if (mgo.opt != nullptr) {
-				_file_to_saveload.name = mgo.opt;
-				bool is_scenario = _switch_mode == SM_EDITOR || _switch_mode == SM_LOAD_SCENARIO;
-				_switch_mode = is_scenario ? SM_LOAD_SCENARIO : SM_LOAD_GAME;
-				_file_to_saveload.SetMode(SLO_LOAD, is_scenario ? FT_SCENARIO : FT_SAVEGAME, DFT_GAME_FILE);
-
-				/* if the file doesn't exist or it is not a valid savegame, let the saveload code show an error */
-				auto t = _file_to_saveload.name.find_last_of('.');
-				if (t != std::string::npos) {
-					auto [ft, _] = FiosGetSavegameListCallback(SLO_LOAD, _file_to_saveload.name, _file_to_saveload.name.substr(t));
-					if (ft != FIOS_TYPE_INVALID) _file_to_saveload.SetMode(ft);
-				}
-
+				SetStartupSavegame(mgo.opt);
 				break;
 			}
 
@@ -632,6 +657,9 @@ int openttd_main(int argc, char *argv[])
 		if (i == -2) break;
 	}
 
+	/* The number of ticks is only known after all options have been parsed. */
+	if (benchmark) videodriver = fmt::format("null:ticks={}:benchmark", benchmark_ticks);
+
 	if (i == -2 || mgo.numleft > 0) {
 		/* Either the user typed '-h', they made an error, or they added unrecognized command line arguments.
 		 * In all cases, print the help, and exit.
@@ -1184,6 +1212,13 @@ static void CheckCaches()
 		i++;
 	}
 
+	/* Check the distances to the landmarks of YAPF. */
+	if (!_rail_landmarks.CheckDistances()) Debug(desync, 2, "rail landmark distances mismatch");
+	if (!_road_landmarks.CheckDistances()) Debug(desync, 2, "road landmark distances mismatch");
+
+	/* Check the trackdirs in the track status cache; mismatches are logged per tile. */
+	CheckTrackStatusCache();
+
 	/* Check company infrastructure cache. */
 	std::vector<CompanyInfrastructure> old_infrastructure;
 	for (const Company *c : Company::Iterate()) old_infrastructure.push_back(c->infrastructure);
@@ -1320,6 +1355,13 @@ static void CheckCaches()
 			}
 		}
 
+		/* Check the cargo types with ratings to update */
+		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			if (Station::NeedsRatingUpdate(st->goods[c]) && !HasBit(st->rating_cargoes, c)) {
+				Debug(desync, 2, "station rating cargoes mismatch: station {}, cargo {}", st->index, c);
+			}
+		}
+
 		/* Check industries_near */
 		IndustryList industries_near = st->industries_near;
 		st->RecomputeCatchment();
@@ -1328,6 +1370,13 @@ static void CheckCaches()
 		}
 	}
 
+	/* Check the set of stations with loading vehicles */
+	std::set<StationID> old_loading_stations = _loading_stations;
+	RebuildLoadingStations();
+	if (old_loading_stations != _loading_stations) {
+		Debug(desync, 2, "loading stations mismatch");
+	}
+
 	/* Check stations_near */
 	i = 0;
 	for (Town *t : Town::Iterate()) {
@@ -1343,6 +1392,9 @@ static void CheckCaches()
 		}
 		i++;
 	}
+
+	/* Check the water regions used by the ship pathfinder. */
+	CheckWaterRegionCaches();
 }
 
 /**
@@ -1365,6 +1417,13 @@ void StateGameLoop()
 		PerformanceMeasurer::Paused(PFE_GL_SHIPS);
 		PerformanceMeasurer::Paused(PFE_GL_AIRCRAFT);
 		PerformanceMeasurer::Paused(PFE_GL_LANDSCAPE);
+		PerformanceMeasurer::Paused(PFE_GL_PF_TRAINS);
+		PerformanceMeasurer::Paused(PFE_GL_PF_ROADVEHS);
+		PerformanceMeasurer::Paused(PFE_GL_PF_SHIPS);
+		PerformanceMeasurer::Paused(PFE_GL_AUTOREPLACE);
+		PerformanceMeasurer::Paused(PFE_GL_TILELOOP);
+		PerformanceMeasurer::Paused(PFE_GL_TOWNS);
+		PerformanceMeasurer::Paused(PFE_GL_INDUSTRIES);
 
 		if (!HasModalProgress()) UpdateLandscapingLimits();
 #ifndef DEBUG_DUMP_COMMANDS
@@ -1375,6 +1434,9 @@ void StateGameLoop()
 
 	PerformanceMeasurer framerate(PFE_GAMELOOP);
 	PerformanceAccumulator::Reset(PFE_GL_LANDSCAPE);
+	PerformanceAccumulator::Reset(PFE_GL_TILELOOP);
+	PerformanceAccumulator::Reset(PFE_GL_TOWNS);
+	PerformanceAccumulator::Reset(PFE_GL_INDUSTRIES);
 
 	Layouter::ReduceLineCache();
 
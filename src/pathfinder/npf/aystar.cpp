@@ -22,32 +22,41 @@
  */
 
 #include "../../stdafx.h"
-#include "../../core/alloc_func.hpp"
 #include "aystar.h"
 
 #include "../../safeguards.h"
 
 /**
- * This looks in the hash whether a node exists in the closed list.
+ * This looks in the index whether a node exists in the closed list.
  * @param node Node to search.
  * @return The #PathNode if it is available, else \c nullptr
  */
 PathNode *AyStar::ClosedListIsInList(const AyStarNode *node)
 {
-	return (PathNode*)this->closedlist_hash.Get(node->tile, node->direction);
+	AyStarNodeIndex::Slot *slot = this->node_index.Find(node->tile, node->direction);
+	if (slot == nullptr || slot->list != AyStarList::Closed) return nullptr;
+	return &this->GetClosedNode(slot->node);
 }
 
 /**
  * This adds a node to the closed list.
  * It makes a copy of the data.
- * @param node Node to add to the closed list.
+ * @param node Node to add to the closed list; it must just have been popped from the open list.
  */
 void AyStar::ClosedListAdd(const PathNode *node)
 {
-	/* Add a node to the ClosedList */
-	PathNode *new_node = MallocT<PathNode>(1);
-	*new_node = *node;
-	this->closedlist_hash.Set(node->node.tile, node->node.direction, new_node);
+	/* Nodes of the closed list never move, so allocate them in blocks. */
+	if (this->closedlist_size == this->closedlist_blocks.size() * CLOSEDLIST_BLOCK_SIZE) {
+		this->closedlist_blocks.push_back(std::make_unique<PathNode[]>(CLOSEDLIST_BLOCK_SIZE));
+	}
+	uint index = this->closedlist_size++;
+	this->GetClosedNode(index) = *node;
+
+	/* The node is still indexed as being in the open list. */
+	AyStarNodeIndex::Slot *slot = this->node_index.Find(node->node.tile, node->node.direction);
+	assert(slot != nullptr && slot->list == AyStarList::Open);
+	slot->list = AyStarList::Closed;
+	slot->node = index;
 }
 
 /**
@@ -57,23 +66,26 @@ void AyStar::ClosedListAdd(const PathNode *node)
  */
 OpenListNode *AyStar::OpenListIsInList(const AyStarNode *node)
 {
-	return (OpenListNode*)this->openlist_hash.Get(node->tile, node->direction);
+	AyStarNodeIndex::Slot *slot = this->node_index.Find(node->tile, node->direction);
+	if (slot == nullptr || slot->list != AyStarList::Open) return nullptr;
+	return &this->openlist_nodes[slot->node];
 }
 
 /**
  * Gets the best node from the open list.
- * It deletes the returned node from the open list.
- * @returns the best node available, or \c nullptr of none is found.
+ * It deletes the returned node from the open list, but it stays indexed
+ * until #ClosedListAdd moves it to the closed list or the search ends.
+ * @param[out] node The best node available.
+ * @return Whether there was a node in the open list.
  */
-OpenListNode *AyStar::OpenListPop()
+bool AyStar::OpenListPop(OpenListNode &node)
 {
-	/* Return the item the Queue returns.. the best next OpenList item. */
-	OpenListNode *res = (OpenListNode*)this->openlist_queue.Pop();
-	if (res != nullptr) {
-		this->openlist_hash.DeleteValue(res->path.node.tile, res->path.node.direction);
-	}
+	if (this->openlist_queue.IsEmpty()) return false;
 
-	return res;
+	uint32_t index = this->openlist_queue.Pop();
+	node = this->openlist_nodes[index];
+	this->openlist_free.push_back(index);
+	return true;
 }
 
 /**
@@ -82,15 +94,27 @@ OpenListNode *AyStar::OpenListPop()
  */
 void AyStar::OpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g)
 {
-	/* Add a new Node to the OpenList */
-	OpenListNode *new_node = MallocT<OpenListNode>(1);
-	new_node->g = g;
-	new_node->path.parent = parent;
-	new_node->path.node = *node;
-	this->openlist_hash.Set(node->tile, node->direction, new_node);
+	/* Add a new Node to the OpenList, reusing a free one when there is one. */
+	uint32_t index;
+	if (this->openlist_free.empty()) {
+		index = static_cast<uint32_t>(this->openlist_nodes.size());
+		this->openlist_nodes.emplace_back();
+	} else {
+		index = this->openlist_free.back();
+		this->openlist_free.pop_back();
+	}
+
+	OpenListNode &new_node = this->openlist_nodes[index];
+	new_node.g = g;
+	new_node.path.parent = parent;
+	new_node.path.node = *node;
+
+	AyStarNodeIndex::Slot &slot = this->node_index.Insert(node->tile, node->direction);
+	slot.list = AyStarList::Open;
+	slot.node = index;
 
 	/* Add it to the queue */
-	this->openlist_queue.Push(new_node, f);
+	this->openlist_queue.Push(index, f);
 }
 
 /**
@@ -100,10 +124,10 @@ void AyStar::CheckTile(AyStarNode *current, OpenListNode *parent)
 {
 	int new_f, new_g, new_h;
 	PathNode *closedlist_parent;
-	OpenListNode *check;
 
 	/* Check the new node against the ClosedList */
-	if (this->ClosedListIsInList(current) != nullptr) return;
+	AyStarNodeIndex::Slot *slot = this->node_index.Find(current->tile, current->direction);
+	if (slot != nullptr && slot->list == AyStarList::Closed) return;
 
 	/* Calculate the G-value for this node */
 	new_g = this->CalculateG(this, current, parent);
@@ -128,21 +152,19 @@ void AyStar::CheckTile(AyStarNode *current, OpenListNode *parent)
 	closedlist_parent = this->ClosedListIsInList(&parent->path.node);
 
 	/* Check if this item is already in the OpenList */
-	check = this->OpenListIsInList(current);
-	if (check != nullptr) {
-		uint i;
+	if (slot != nullptr) {
+		OpenListNode &check = this->openlist_nodes[slot->node];
 		/* Yes, check if this g value is lower.. */
-		if (new_g > check->g) return;
-		this->openlist_queue.Delete(check, 0);
+		if (new_g > check.g) return;
 		/* It is lower, so change it to this item */
-		check->g = new_g;
-		check->path.parent = closedlist_parent;
+		check.g = new_g;
+		check.path.parent = closedlist_parent;
 		/* Copy user data, will probably have changed */
-		for (i = 0; i < lengthof(current->user_data); i++) {
-			check->path.node.user_data[i] = current->user_data[i];
+		for (uint i = 0; i < lengthof(current->user_data); i++) {
+			check.path.node.user_data[i] = current->user_data[i];
 		}
-		/* Re-add it in the openlist_queue. */
-		this->openlist_queue.Push(check, new_f);
+		/* Move it to its new place in the openlist_queue. */
+		this->openlist_queue.Update(slot->node, new_f);
 	} else {
 		/* A new node, add it to the OpenList */
 		this->OpenListAdd(closedlist_parent, current, new_f, new_g);
@@ -163,35 +185,31 @@ int AyStar::Loop()
 	int i;
 
 	/* Get the best node from OpenList */
-	OpenListNode *current = this->OpenListPop();
+	OpenListNode current;
 	/* If empty, drop an error */
-	if (current == nullptr) return AYSTAR_EMPTY_OPENLIST;
+	if (!this->OpenListPop(current)) return AYSTAR_EMPTY_OPENLIST;
 
 	/* Check for end node and if found, return that code */
-	if (this->EndNodeCheck(this, current) == AYSTAR_FOUND_END_NODE && !CheckIgnoreFirstTile(&current->path)) {
+	if (this->EndNodeCheck(this, &current) == AYSTAR_FOUND_END_NODE && !CheckIgnoreFirstTile(&current.path)) {
 		if (this->FoundEndNode != nullptr) {
-			this->FoundEndNode(this, current);
+			this->FoundEndNode(this, &current);
 		}
-		free(current);
 		return AYSTAR_FOUND_END_NODE;
 	}
 
 	/* Add the node to the ClosedList */
-	this->ClosedListAdd(&current->path);
+	this->ClosedListAdd(&current.path);
 
 	/* Load the neighbours */
-	this->GetNeighbours(this, current);
+	this->GetNeighbours(this, &current);
 
 	/* Go through all neighbours */
 	for (i = 0; i < this->num_neighbours; i++) {
 		/* Check and add them to the OpenList if needed */
-		this->CheckTile(&this->neighbours[i], current);
+		this->CheckTile(&this->neighbours[i], &current);
 	}
 
-	/* Free the node */
-	free(current);
-
-	if (this->max_search_nodes != 0 && this->closedlist_hash.GetSize() >= this->max_search_nodes) {
+	if (this->max_search_nodes != 0 && this->closedlist_size >= this->max_search_nodes) {
 		/* We've expanded enough nodes */
 		return AYSTAR_LIMIT_REACHED;
 	} else {
@@ -205,11 +223,13 @@ int AyStar::Loop()
  */
 void AyStar::Free()
 {
-	this->openlist_queue.Free(false);
-	/* 2nd argument above is false, below is true, to free the values only
-	 * once */
-	this->openlist_hash.Delete(true);
-	this->closedlist_hash.Delete(true);
+	this->openlist_queue.Free();
+	this->openlist_nodes = {};
+	this->openlist_free = {};
+	this->closedlist_blocks.clear();
+	this->closedlist_blocks.shrink_to_fit();
+	this->closedlist_size = 0;
+	this->node_index.Free();
 #ifdef AYSTAR_DEBUG
 	Debug(misc, 0, "[AyStar] Memory free'd");
 #endif
@@ -218,15 +238,16 @@ void AyStar::Free()
 /**
  * This function make the memory go back to zero.
  * This function should be called when you are using the same instance again.
+ * The memory is kept for the next search, and the index is cleared by
+ * starting a new generation, so this does not touch every node.
  */
 void AyStar::Clear()
 {
-	/* Clean the Queue, but not the elements within. That will be done by
-	 * the hash. */
-	this->openlist_queue.Clear(false);
-	/* Clean the hashes */
-	this->openlist_hash.Clear(true);
-	this->closedlist_hash.Clear(true);
+	this->openlist_queue.Clear();
+	this->openlist_nodes.clear();
+	this->openlist_free.clear();
+	this->closedlist_size = 0;
+	this->node_index.Clear();
 
 #ifdef AYSTAR_DEBUG
 	Debug(misc, 0, "[AyStar] Cleared AyStar");
@@ -289,16 +310,10 @@ void AyStar::AddStartNode(AyStarNode *start_node, uint g)
 /**
  * Initialize an #AyStar. You should fill all appropriate fields before
  * calling #Init (see the declaration of #AyStar for which fields are internal).
+ * @param capacity Number of nodes to make room for in advance; the lists grow when needed.
  */
-void AyStar::Init(Hash_HashProc hash, uint num_buckets)
+void AyStar::Init(uint capacity)
 {
-	/* Allocated the Hash for the OpenList and ClosedList */
-	this->openlist_hash.Init(hash, num_buckets);
-	this->closedlist_hash.Init(hash, num_buckets);
-
-	/* Set up our sorting queue
-	 *  BinaryHeap allocates a block of 1024 nodes
-	 *  When that one gets full it reserves another one, till this number
-	 *  That is why it can stay this high */
-	this->openlist_queue.Init(102400);
+	this->node_index.Init(capacity);
+	this->openlist_nodes.reserve(capacity);
 }
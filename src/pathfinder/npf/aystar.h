@@ -142,7 +142,7 @@ struct AyStar {
 	AyStarNode neighbours[12];
 	byte num_neighbours;
 
-	void Init(Hash_HashProc hash, uint num_buckets);
+	void Init(uint capacity);
 
 	/* These will contain the methods for manipulating the AyStar. Only
 	 * Main() should be called externally */
@@ -154,16 +154,31 @@ struct AyStar {
 	void CheckTile(AyStarNode *current, OpenListNode *parent);
 
 protected:
-	Hash       closedlist_hash; ///< The actual closed list.
-	BinaryHeap openlist_queue;  ///< The open queue.
-	Hash       openlist_hash;   ///< An extra hash to speed up the process of looking up an element in the open list.
+	static const uint CLOSEDLIST_BLOCK_SIZE = 1024; ///< Number of nodes in a block of the closed list.
+
+	QuaternaryHeap openlist_queue;            ///< The open queue, of indices into #openlist_nodes.
+	std::vector<OpenListNode> openlist_nodes; ///< The nodes of the open list, including free ones.
+	std::vector<uint32_t> openlist_free;      ///< Indices of the free nodes in #openlist_nodes.
+	std::vector<std::unique_ptr<PathNode[]>> closedlist_blocks; ///< The closed list; its nodes never move, as they are parents of other nodes.
+	uint closedlist_size = 0;                 ///< Number of nodes in the closed list.
+	AyStarNodeIndex node_index;               ///< Lookup of the nodes of both lists by tile and direction.
 
 	void OpenListAdd(PathNode *parent, const AyStarNode *node, int f, int g);
 	OpenListNode *OpenListIsInList(const AyStarNode *node);
-	OpenListNode *OpenListPop();
+	bool OpenListPop(OpenListNode &node);
 
 	void ClosedListAdd(const PathNode *node);
 	PathNode *ClosedListIsInList(const AyStarNode *node);
+
+	/**
+	 * Get a node of the closed list.
+	 * @param index Index of the node.
+	 * @return The node.
+	 */
+	inline PathNode &GetClosedNode(uint index)
+	{
+		return this->closedlist_blocks[index / CLOSEDLIST_BLOCK_SIZE][index % CLOSEDLIST_BLOCK_SIZE];
+	}
 };
 
 #endif /* AYSTAR_H */
@@ -5,105 +5,103 @@
  * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
  */
 
-/** @file queue.h Binary heap implementation, hash implementation. */
+/** @file queue.h Priority queue and node index of %AyStar. */
 
 #ifndef QUEUE_H
 #define QUEUE_H
 
-//#define HASH_STATS
-
-
-struct BinaryHeapNode {
-	void *item;
-	int priority;
-};
-
+#include "../../tile_type.h"
+#include "../../track_type.h"
 
 /**
- * Binary Heap.
- * For information, see: http://www.policyalmanac.org/games/binaryHeaps.htm
+ * Priority queue of node indices, as a 4-ary heap.
+ * A 4-ary heap is half as deep as a binary heap, and the children of a
+ * node are next to each other in memory, so sifting touches fewer cache
+ * lines. The position of every node in the heap is kept, so the priority
+ * of a node can be changed without searching for it.
  */
-struct BinaryHeap {
-	static const int BINARY_HEAP_BLOCKSIZE;
-	static const int BINARY_HEAP_BLOCKSIZE_BITS;
-	static const int BINARY_HEAP_BLOCKSIZE_MASK;
+class QuaternaryHeap {
+	static constexpr uint ARITY = 4;                 ///< Number of children of an item.
+	static constexpr uint32_t NOT_QUEUED = UINT32_MAX; ///< Position of nodes that are not in the heap.
+
+	/** Item of the heap. */
+	struct Item {
+		int priority;  ///< Priority of the node; the lowest comes first.
+		uint32_t node; ///< The node.
+	};
 
-	void Init(uint max_size);
+	std::vector<Item> items;         ///< The heap.
+	std::vector<uint32_t> positions; ///< Position of each node in #items.
 
-	bool Push(void *item, int priority);
-	void *Pop();
-	bool Delete(void *item, int priority);
-	void Clear(bool free_values);
-	void Free(bool free_values);
+	void SiftUp(uint32_t pos, Item item);
+	void SiftDown(uint32_t pos, Item item);
 
+public:
 	/**
-	 * Get an element from the #elements.
-	 * @param i Element to access (starts at offset \c 1).
-	 * @return Value of the element.
+	 * Whether the queue has no nodes.
+	 * @return True iff the queue is empty.
 	 */
-	inline BinaryHeapNode &GetElement(uint i)
+	inline bool IsEmpty() const
 	{
-		assert(i > 0);
-		return this->elements[(i - 1) >> BINARY_HEAP_BLOCKSIZE_BITS][(i - 1) & BINARY_HEAP_BLOCKSIZE_MASK];
+		return this->items.empty();
 	}
 
-	uint max_size;
-	uint size;
-	uint blocks; ///< The amount of blocks for which space is reserved in elements
-	BinaryHeapNode **elements;
+	void Push(uint32_t node, int priority);
+	uint32_t Pop();
+	void Update(uint32_t node, int priority);
+	void Clear();
+	void Free();
 };
 
-
-/*
- * Hash
- */
-struct HashNode {
-	uint key1;
-	uint key2;
-	void *value;
-	HashNode *next;
+/** List of %AyStar a node is in. */
+enum class AyStarList : uint8_t {
+	Open,   ///< The node is in the open list.
+	Closed, ///< The node is in the closed list.
 };
+
 /**
- * Generates a hash code from the given key pair. You should make sure that
- * the resulting range is clearly defined.
+ * Index of the nodes of an %AyStar search by tile and direction.
+ * It is a flat hash table with linear probing. Every slot remembers the
+ * generation it was written in, and slots of older generations are free,
+ * so clearing the index only starts a new generation. Nodes are never
+ * removed during a search, they only move from the open to the closed list.
  */
-typedef uint Hash_HashProc(uint key1, uint key2);
-struct Hash {
-	/* The hash function used */
-	Hash_HashProc *hash;
-	/* The amount of items in the hash */
-	uint size;
-	/* The number of buckets allocated */
-	uint num_buckets;
-	/* A pointer to an array of num_buckets buckets. */
-	HashNode *buckets;
-	/* A pointer to an array of numbuckets booleans, which will be true if
-	 * there are any Nodes in the bucket */
-	bool *buckets_in_use;
-
-	void Init(Hash_HashProc *hash, uint num_buckets);
-
-	void *Get(uint key1, uint key2) const;
-	void *Set(uint key1, uint key2, void *value);
-
-	void *DeleteValue(uint key1, uint key2);
-
-	void Clear(bool free_values);
-	void Delete(bool free_values);
+class AyStarNodeIndex {
+public:
+	/** Slot of the index. */
+	struct Slot {
+		uint32_t generation; ///< Generation the slot was written in.
+		TileIndex tile;      ///< Tile of the node.
+		Trackdir direction;  ///< Direction of the node.
+		AyStarList list;     ///< List the node is in.
+		uint32_t node;       ///< Index of the node in its list.
+	};
+
+private:
+	std::vector<Slot> slots; ///< The slots; the number is a power of two.
+	uint32_t generation = 1; ///< Generation of the used slots.
+	uint count = 0;          ///< Number of used slots.
 
 	/**
-	 * Gets the current size of the hash.
+	 * Get the first slot to probe for a node.
+	 * @param tile Tile of the node.
+	 * @param direction Direction of the node.
+	 * @return Index of the slot.
 	 */
-	inline uint GetSize() const
+	inline uint FirstSlot(TileIndex tile, Trackdir direction) const
 	{
-		return this->size;
+		uint64_t hash = (static_cast<uint64_t>(static_cast<uint32_t>(tile)) << 8 | direction) * 0x9E3779B97F4A7C15ULL;
+		return static_cast<uint>(hash >> 32) & (static_cast<uint>(this->slots.size()) - 1);
 	}
 
-protected:
-#ifdef HASH_STATS
-	void PrintStatistics() const;
-#endif
-	HashNode *FindNode(uint key1, uint key2, HashNode** prev_out) const;
+	void Grow();
+
+public:
+	void Init(uint capacity);
+	Slot *Find(TileIndex tile, Trackdir direction);
+	Slot &Insert(TileIndex tile, Trackdir direction);
+	void Clear();
+	void Free();
 };
 
 #endif /* QUEUE_H */
@@ -12,6 +12,7 @@
 
 #include "../tile_cmd.h"
 #include "../waypoint_base.h"
+#include "track_status_cache.h"
 
 /**
  * Calculates the tile of given station that is closest to a given tile
@@ -59,7 +60,7 @@ static inline TileIndex CalcClosestStationTile(StationID station, TileIndex tile
  */
 static inline TrackdirBits GetTrackdirBitsForRoad(TileIndex tile, RoadTramType rtt)
 {
-	TrackdirBits bits = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_ROAD, rtt));
+	TrackdirBits bits = GetTileTrackdirBits(tile, TRANSPORT_ROAD, rtt);
 
 	if (rtt == RTT_TRAM && bits == TRACKDIR_BIT_NONE) {
 		if (IsNormalRoadTile(tile)) {
@@ -0,0 +1,106 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file track_status_cache.cpp Side table of the trackdirs available on every tile, for the track followers. */
+
+#include "../stdafx.h"
+#include "../debug.h"
+#include "../map_func.h"
+#include "../road.h"
+#include "../settings_type.h"
+#include "../tile_cmd.h"
+#include "../track_func.h"
+#include "track_status_cache.h"
+
+#include "../safeguards.h"
+
+std::unique_ptr<std::atomic<uint16_t>[]> _track_status_cache;
+
+/** Number of entries of the track status cache. */
+static size_t _track_status_cache_size = 0;
+
+/**
+ * Get the trackdirs available on a tile from the map, and store them in the
+ * track status cache when it is enabled.
+ * @param tile The tile.
+ * @param mode Transport type; rail, road or water.
+ * @param sub_mode For road, the RoadTramType; 0 otherwise.
+ * @return The trackdirs.
+ */
+TrackdirBits UpdateTrackStatusCache(TileIndex tile, TransportType mode, uint sub_mode)
+{
+	assert(mode == TRANSPORT_RAIL || mode == TRANSPORT_ROAD || mode == TRANSPORT_WATER);
+
+	TrackdirBits bits = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, mode, sub_mode));
+	if (_track_status_cache != nullptr) {
+		_track_status_cache[static_cast<uint32_t>(tile) * TSCT_END + GetTrackStatusCacheTable(mode, sub_mode)].store(bits, std::memory_order_relaxed);
+	}
+	return bits;
+}
+
+/**
+ * Allocate or free the track status cache as the setting says, and forget all entries.
+ * Call this whenever the map is replaced or changes in ways that are not reported per tile.
+ */
+void InitializeTrackStatusCache()
+{
+	if (!_settings_game.pf.track_status_cache) {
+		_track_status_cache.reset();
+		_track_status_cache_size = 0;
+		return;
+	}
+
+	size_t size = static_cast<size_t>(Map::Size()) * TSCT_END;
+	if (size != _track_status_cache_size) {
+		_track_status_cache.reset(new std::atomic<uint16_t>[size]);
+		_track_status_cache_size = size;
+	}
+	for (size_t i = 0; i < size; i++) _track_status_cache[i].store(TRACK_STATUS_CACHE_UNKNOWN, std::memory_order_relaxed);
+}
+
+/**
+ * Forget the entries of a tile, as its track layout, road works, water or slope changed.
+ * @param tile The tile, or INVALID_TILE to forget all entries.
+ */
+void InvalidateTrackStatusCache(TileIndex tile)
+{
+	if (_track_status_cache == nullptr) return;
+
+	if (tile == INVALID_TILE) {
+		InitializeTrackStatusCache();
+		return;
+	}
+
+	for (uint table = 0; table < TSCT_END; table++) {
+		_track_status_cache[static_cast<uint32_t>(tile) * TSCT_END + table].store(TRACK_STATUS_CACHE_UNKNOWN, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * Check that all known entries of the track status cache match the map.
+ * @return True iff no entry differs from what the map says.
+ */
+bool CheckTrackStatusCache()
+{
+	if (_track_status_cache == nullptr) return true;
+
+	static const TransportType modes[TSCT_END] = { TRANSPORT_RAIL, TRANSPORT_ROAD, TRANSPORT_ROAD, TRANSPORT_WATER };
+	static const uint sub_modes[TSCT_END] = { 0, RTT_ROAD, RTT_TRAM, 0 };
+
+	bool ok = true;
+	for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+		for (uint table = 0; table < TSCT_END; table++) {
+			uint16_t bits = _track_status_cache[static_cast<uint32_t>(tile) * TSCT_END + table].load(std::memory_order_relaxed);
+			if (bits == TRACK_STATUS_CACHE_UNKNOWN) continue;
+			if (bits != TrackStatusToTrackdirBits(GetTileTrackStatus(tile, modes[table], sub_modes[table]))) {
+				Debug(desync, 2, "track status cache mismatch: tile {}, table {}", tile, table);
+				ok = false;
+			}
+		}
+	}
+	return ok;
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file track_status_cache.h Side table of the trackdirs available on every tile, for the track followers. */
+
+#ifndef TRACK_STATUS_CACHE_H
+#define TRACK_STATUS_CACHE_H
+
+#include "../tile_type.h"
+#include "../track_type.h"
+#include "../transport_type.h"
+
+#include <atomic>
+
+/** The tables of the track status cache; a tile has an entry in each of them. */
+enum TrackStatusCacheTable : uint8_t {
+	TSCT_RAIL,  ///< Trackdirs for trains.
+	TSCT_ROAD,  ///< Trackdirs for road vehicles.
+	TSCT_TRAM,  ///< Trackdirs for trams.
+	TSCT_WATER, ///< Trackdirs for ships.
+	TSCT_END,   ///< Number of tables.
+};
+
+/** Value of the entries that are not known yet; trackdir bits never have all bits set. */
+static const uint16_t TRACK_STATUS_CACHE_UNKNOWN = UINT16_MAX;
+
+/**
+ * The entries of the track status cache, #TSCT_END per tile, or nullptr when it is disabled.
+ * Entries are filled when first asked for, possibly by several pathfinder
+ * threads at once; those all store the same value, hence relaxed atomics.
+ */
+extern std::unique_ptr<std::atomic<uint16_t>[]> _track_status_cache;
+
+/**
+ * Get the table of the track status cache for a kind of track.
+ * @param mode Transport type; rail, road or water.
+ * @param sub_mode For road, the RoadTramType; 0 otherwise.
+ * @return The table.
+ */
+inline uint GetTrackStatusCacheTable(TransportType mode, uint sub_mode)
+{
+	if (mode == TRANSPORT_RAIL) return TSCT_RAIL;
+	if (mode == TRANSPORT_ROAD) return TSCT_ROAD + sub_mode;
+	return TSCT_WATER;
+}
+
+TrackdirBits UpdateTrackStatusCache(TileIndex tile, TransportType mode, uint sub_mode);
+
+void InitializeTrackStatusCache();
+void InvalidateTrackStatusCache(TileIndex tile);
+bool CheckTrackStatusCache();
+
+/**
+ * Get the trackdirs available on a tile, like the lower half of GetTileTrackStatus
+ * for all sides, but from the track status cache when it is enabled.
+ * @param tile The tile.
+ * @param mode Transport type; rail, road or water.
+ * @param sub_mode For road, the RoadTramType; 0 otherwise.
+ * @return The trackdirs.
+ */
+inline TrackdirBits GetTileTrackdirBits(TileIndex tile, TransportType mode, uint sub_mode)
+{
+	if (_track_status_cache != nullptr) {
+		uint16_t bits = _track_status_cache[static_cast<uint32_t>(tile) * TSCT_END + GetTrackStatusCacheTable(mode, sub_mode)].load(std::memory_order_relaxed);
+		if (bits != TRACK_STATUS_CACHE_UNKNOWN) return (TrackdirBits)bits;
+	}
+	return UpdateTrackStatusCache(tile, mode, sub_mode);
+}
+
+#endif /* TRACK_STATUS_CACHE_H */
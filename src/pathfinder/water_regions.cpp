@@ -0,0 +1,418 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.cpp Handles dividing the water in the map into square regions to assist pathfinding. */
+
+#include "../stdafx.h"
+#include "../map_func.h"
+#include "../tile_cmd.h"
+#include "../tunnelbridge_map.h"
+#include "../tilearea_type.h"
+#include "../ship.h"
+#include "../debug.h"
+#include "follow_track.hpp"
+#include "yapf/yapf_cache.h"
+#include "water_regions.h"
+
+#include "../safeguards.h"
+
+using TWaterRegionTraversabilityBits = uint16_t;
+
+static_assert(sizeof(TWaterRegionTraversabilityBits) * 8 == WATER_REGION_EDGE_LENGTH);
+
+/**
+ * Get the number of water regions along the X-axis of the map.
+ * @return Number of water regions along the X-axis.
+ */
+static inline int GetWaterRegionMapSizeX()
+{
+	return Map::SizeX() / WATER_REGION_EDGE_LENGTH;
+}
+
+/**
+ * Get the number of water regions along the Y-axis of the map.
+ * @return Number of water regions along the Y-axis.
+ */
+static inline int GetWaterRegionMapSizeY()
+{
+	return Map::SizeY() / WATER_REGION_EDGE_LENGTH;
+}
+
+/**
+ * Get the index of a water region in the table of water regions.
+ * @param region_x X coordinate of the water region.
+ * @param region_y Y coordinate of the water region.
+ * @return Index of the water region.
+ */
+static inline TWaterRegionIndex GetWaterRegionIndex(int region_x, int region_y)
+{
+	return region_x + region_y * GetWaterRegionMapSizeX();
+}
+
+/**
+ * Get the index of the water region a tile is part of.
+ * @param tile The tile.
+ * @return Index of the water region.
+ */
+static inline TWaterRegionIndex GetWaterRegionIndex(TileIndex tile)
+{
+	return GetWaterRegionIndex(TileX(tile) / WATER_REGION_EDGE_LENGTH, TileY(tile) / WATER_REGION_EDGE_LENGTH);
+}
+
+/**
+ * Get the trackdirs a ship could use on a tile.
+ * @param tile The tile.
+ * @return The water trackdirs of the tile.
+ */
+static inline TrackdirBits GetWaterTrackdirs(TileIndex tile)
+{
+	return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_WATER, 0));
+}
+
+/**
+ * Square part of the map, in which the tiles reachable from each other
+ * without leaving the region are grouped into patches. Besides the patches
+ * the region knows at which tiles of its edges ships can leave it, so the
+ * connections between the patches of neighbouring regions can be found.
+ * The data is derived from the map on first use after the region was
+ * invalidated.
+ */
+class WaterRegion {
+private:
+	std::array<TWaterRegionTraversabilityBits, DIAGDIR_END> edge_traversability_bits{}; ///< Per side, the edge tiles at which a ship can leave the region.
+	bool has_cross_region_aqueducts = false; ///< Whether an aqueduct leads from this region straight into another one.
+	TWaterRegionPatchLabel number_of_patches = 0; ///< Number of patches in this region.
+	bool initialized = false; ///< Whether the data of the region is up to date.
+	std::vector<TWaterRegionPatchLabel> tile_patch_labels; ///< The patch label of each tile, empty before the region is used for the first time.
+	int x; ///< X coordinate of the region.
+	int y; ///< Y coordinate of the region.
+
+	/**
+	 * Get the index of a tile within this region.
+	 * @param tile Tile within this region.
+	 * @return Index of the tile in #tile_patch_labels.
+	 */
+	inline int GetLocalIndex(TileIndex tile) const
+	{
+		assert(this->ContainsTile(tile));
+		return (TileX(tile) - this->x * WATER_REGION_EDGE_LENGTH) + (TileY(tile) - this->y * WATER_REGION_EDGE_LENGTH) * WATER_REGION_EDGE_LENGTH;
+	}
+
+	/**
+	 * Get the position of an edge tile along the given side of this region.
+	 * @param tile Tile at the edge of this region.
+	 * @param side Side of the region the tile is at.
+	 * @return Position of the tile along the edge.
+	 */
+	inline int GetEdgePosition(TileIndex tile, DiagDirection side) const
+	{
+		return DiagDirToAxis(side) == AXIS_X ? TileY(tile) - this->y * WATER_REGION_EDGE_LENGTH : TileX(tile) - this->x * WATER_REGION_EDGE_LENGTH;
+	}
+
+public:
+	WaterRegion(int region_x, int region_y) : x(region_x), y(region_y) {}
+
+	/**
+	 * Check whether a tile lies within this region.
+	 * @param tile The tile.
+	 * @return True iff the tile is part of this region.
+	 */
+	inline bool ContainsTile(TileIndex tile) const
+	{
+		return static_cast<int>(TileX(tile)) / WATER_REGION_EDGE_LENGTH == this->x && static_cast<int>(TileY(tile)) / WATER_REGION_EDGE_LENGTH == this->y;
+	}
+
+	/**
+	 * Get the tile at a position along an edge of this region.
+	 * @param side Side of the region.
+	 * @param position Position along that side.
+	 * @return The tile at the edge.
+	 */
+	inline TileIndex GetEdgeTile(DiagDirection side, int position) const
+	{
+		int base_x = this->x * WATER_REGION_EDGE_LENGTH;
+		int base_y = this->y * WATER_REGION_EDGE_LENGTH;
+		switch (side) {
+			case DIAGDIR_NE: return TileXY(base_x, base_y + position);
+			case DIAGDIR_SW: return TileXY(base_x + WATER_REGION_EDGE_LENGTH - 1, base_y + position);
+			case DIAGDIR_NW: return TileXY(base_x + position, base_y);
+			case DIAGDIR_SE: return TileXY(base_x + position, base_y + WATER_REGION_EDGE_LENGTH - 1);
+			default: NOT_REACHED();
+		}
+	}
+
+	/**
+	 * Get at which tiles along a side ships can leave this region.
+	 * @param side Side of the region.
+	 * @return Bit \c i is set when a ship can leave via the tile at position \c i.
+	 */
+	inline TWaterRegionTraversabilityBits GetEdgeTraversabilityBits(DiagDirection side) const
+	{
+		return this->edge_traversability_bits[side];
+	}
+
+	/**
+	 * Check whether an aqueduct leads from this region into another one.
+	 * @return True iff the region has an aqueduct ramp with its other end in another region.
+	 */
+	inline bool HasCrossRegionAqueducts() const
+	{
+		return this->has_cross_region_aqueducts;
+	}
+
+	/**
+	 * Get the patch a tile of this region is part of.
+	 * @param tile Tile within this region.
+	 * @return The patch label, or INVALID_WATER_REGION_PATCH when ships cannot use the tile.
+	 */
+	inline TWaterRegionPatchLabel GetLabel(TileIndex tile) const
+	{
+		assert(this->initialized);
+		return this->tile_patch_labels[this->GetLocalIndex(tile)];
+	}
+
+	/** Mark the data of this region as outdated, it is rebuilt when it is used next. */
+	inline void Invalidate()
+	{
+		this->initialized = false;
+	}
+
+	/**
+	 * Check whether the data of this region is up to date.
+	 * @return True iff the data does not have to be rebuilt.
+	 */
+	inline bool IsInitialized() const
+	{
+		return this->initialized;
+	}
+
+	/**
+	 * Rebuild the patches and edge data of this region from the map. Tiles
+	 * are grouped into patches with a flood fill that follows the water
+	 * tracks, tracks leading out of the region mark the edges.
+	 */
+	void ForceUpdate()
+	{
+		this->tile_patch_labels.assign(WATER_REGION_NUMBER_OF_TILES, INVALID_WATER_REGION_PATCH);
+		this->edge_traversability_bits.fill(0);
+		this->has_cross_region_aqueducts = false;
+		this->number_of_patches = 0;
+
+		std::vector<TileIndex> tiles_to_check;
+		TileIndex top_corner = TileXY(this->x * WATER_REGION_EDGE_LENGTH, this->y * WATER_REGION_EDGE_LENGTH);
+		for (TileIndex start_tile : TileArea(top_corner, WATER_REGION_EDGE_LENGTH, WATER_REGION_EDGE_LENGTH)) {
+			if (this->tile_patch_labels[this->GetLocalIndex(start_tile)] != INVALID_WATER_REGION_PATCH) continue;
+			if (GetWaterTrackdirs(start_tile) == TRACKDIR_BIT_NONE) continue;
+
+			TWaterRegionPatchLabel label = ++this->number_of_patches;
+			assert(label != INVALID_WATER_REGION_PATCH);
+			this->tile_patch_labels[this->GetLocalIndex(start_tile)] = label;
+			tiles_to_check.push_back(start_tile);
+
+			while (!tiles_to_check.empty()) {
+				TileIndex tile = tiles_to_check.back();
+				tiles_to_check.pop_back();
+
+				for (TrackdirBits trackdirs = GetWaterTrackdirs(tile); trackdirs != TRACKDIR_BIT_NONE; /* nothing */) {
+					Trackdir td = RemoveFirstTrackdir(&trackdirs);
+					CFollowTrackWater ft;
+					if (!ft.Follow(tile, td)) continue;
+
+					if (this->ContainsTile(ft.m_new_tile)) {
+						TWaterRegionPatchLabel &new_label = this->tile_patch_labels[this->GetLocalIndex(ft.m_new_tile)];
+						if (new_label == INVALID_WATER_REGION_PATCH) {
+							new_label = label;
+							tiles_to_check.push_back(ft.m_new_tile);
+						}
+					} else if (ft.m_tiles_skipped > 0) {
+						/* An aqueduct that ends in another region. */
+						this->has_cross_region_aqueducts = true;
+					} else {
+						SetBit(this->edge_traversability_bits[ft.m_exitdir], this->GetEdgePosition(tile, ft.m_exitdir));
+					}
+				}
+			}
+		}
+
+		this->initialized = true;
+	}
+
+	/** Rebuild the data of this region when it is outdated. */
+	inline void UpdateIfNotInitialized()
+	{
+		if (!this->initialized) this->ForceUpdate();
+	}
+
+	/**
+	 * Compare the data of two regions.
+	 * @param other The region to compare with.
+	 * @return True iff both regions have the same patches and edges.
+	 */
+	bool HasSameData(const WaterRegion &other) const
+	{
+		return this->edge_traversability_bits == other.edge_traversability_bits &&
+				this->has_cross_region_aqueducts == other.has_cross_region_aqueducts &&
+				this->number_of_patches == other.number_of_patches &&
+				this->tile_patch_labels == other.tile_patch_labels;
+	}
+};
+
+/** All water regions of the map, in order of their index. */
+static std::vector<WaterRegion> _water_regions;
+
+/**
+ * Get a water region with up to date data.
+ * @param region_x X coordinate of the water region.
+ * @param region_y Y coordinate of the water region.
+ * @return The water region.
+ */
+static WaterRegion &GetUpdatedWaterRegion(int region_x, int region_y)
+{
+	WaterRegion &region = _water_regions[GetWaterRegionIndex(region_x, region_y)];
+	region.UpdateIfNotInitialized();
+	return region;
+}
+
+/**
+ * Calculate a number that uniquely identifies a water region patch on the map.
+ * @param water_region_patch The water region patch.
+ * @return The unique number.
+ */
+int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch)
+{
+	return water_region_patch.label | GetWaterRegionIndex(water_region_patch.x, water_region_patch.y) << 8;
+}
+
+/**
+ * Get the tile at the center of the region of a water region patch.
+ * @param water_region_patch The water region patch.
+ * @return The center tile of its region, which is not necessarily part of the patch.
+ */
+TileIndex GetWaterRegionCenterTile(const WaterRegionPatchDesc &water_region_patch)
+{
+	return TileXY(water_region_patch.x * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2, water_region_patch.y * WATER_REGION_EDGE_LENGTH + WATER_REGION_EDGE_LENGTH / 2);
+}
+
+/**
+ * Get the water region patch a tile is part of.
+ * @param tile The tile.
+ * @return The water region patch, with label INVALID_WATER_REGION_PATCH when ships cannot use the tile.
+ */
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile)
+{
+	int region_x = TileX(tile) / WATER_REGION_EDGE_LENGTH;
+	int region_y = TileY(tile) / WATER_REGION_EDGE_LENGTH;
+	return WaterRegionPatchDesc{ region_x, region_y, GetUpdatedWaterRegion(region_x, region_y).GetLabel(tile) };
+}
+
+/**
+ * Mark the water region of a tile as outdated, as the water tracks of the
+ * tile might have changed. As a region also knows whether ships can go from
+ * its edge tiles into the neighbouring regions, those are invalidated as
+ * well when the tile is at the edge of its region.
+ * @param tile The tile that changed.
+ */
+void InvalidateWaterRegion(TileIndex tile)
+{
+	YapfNotifyWaterLayoutChange(tile);
+
+	if (_water_regions.empty()) return;
+
+	TWaterRegionIndex index = GetWaterRegionIndex(tile);
+	_water_regions[index].Invalidate();
+
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		TileIndex neighbour = TileAddWrap(tile, TileIndexDiffCByDiagDir(side).x, TileIndexDiffCByDiagDir(side).y);
+		if (neighbour == INVALID_TILE) continue;
+
+		TWaterRegionIndex neighbour_index = GetWaterRegionIndex(neighbour);
+		if (neighbour_index != index) _water_regions[neighbour_index].Invalidate();
+	}
+}
+
+/**
+ * Call a function for every water region patch ships can go to from the given patch.
+ * @param water_region_patch The water region patch to start from.
+ * @param callback Function to call for each neighbouring patch; it may be called more than once for the same patch.
+ */
+void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, TVisitWaterRegionPatchCallBack &callback)
+{
+	const WaterRegion &region = GetUpdatedWaterRegion(water_region_patch.x, water_region_patch.y);
+
+	for (DiagDirection side = DIAGDIR_BEGIN; side < DIAGDIR_END; side++) {
+		TWaterRegionTraversabilityBits traversability_bits = region.GetEdgeTraversabilityBits(side);
+		if (traversability_bits == 0) continue;
+
+		/* A ship can only leave via a side if there is another region at that side. */
+		const TileIndexDiffC offset = TileIndexDiffCByDiagDir(side);
+		const WaterRegion &neighbour = GetUpdatedWaterRegion(water_region_patch.x + offset.x, water_region_patch.y + offset.y);
+
+		/* Report each neighbouring patch only once, even when many edge tiles lead into it. */
+		uint64_t reported[4] = {};
+		for (int position = 0; position < WATER_REGION_EDGE_LENGTH; position++) {
+			if (!HasBit(traversability_bits, position)) continue;
+
+			TileIndex edge_tile = region.GetEdgeTile(side, position);
+			if (region.GetLabel(edge_tile) != water_region_patch.label) continue;
+
+			TWaterRegionPatchLabel neighbour_label = neighbour.GetLabel(TileAddByDiagDir(edge_tile, side));
+			if (neighbour_label == INVALID_WATER_REGION_PATCH) continue;
+			if (HasBit(reported[neighbour_label / 64], neighbour_label % 64)) continue;
+
+			SetBit(reported[neighbour_label / 64], neighbour_label % 64);
+			callback(WaterRegionPatchDesc{ water_region_patch.x + offset.x, water_region_patch.y + offset.y, neighbour_label });
+		}
+	}
+
+	if (region.HasCrossRegionAqueducts()) {
+		TileIndex top_corner = TileXY(water_region_patch.x * WATER_REGION_EDGE_LENGTH, water_region_patch.y * WATER_REGION_EDGE_LENGTH);
+		for (TileIndex tile : TileArea(top_corner, WATER_REGION_EDGE_LENGTH, WATER_REGION_EDGE_LENGTH)) {
+			if (!IsBridgeTile(tile) || GetTunnelBridgeTransportType(tile) != TRANSPORT_WATER) continue;
+			if (region.GetLabel(tile) != water_region_patch.label) continue;
+
+			TileIndex other_end = GetOtherBridgeEnd(tile);
+			if (region.ContainsTile(other_end)) continue;
+
+			WaterRegionPatchDesc other_patch = GetWaterRegionPatchInfo(other_end);
+			if (other_patch.label != INVALID_WATER_REGION_PATCH) callback(other_patch);
+		}
+	}
+}
+
+/**
+ * Allocate the water regions for the current map size.
+ * All regions start out outdated, so they are built when ships first need them.
+ */
+void AllocateWaterRegions()
+{
+	_water_regions.clear();
+	_water_regions.reserve(GetWaterRegionMapSizeX() * GetWaterRegionMapSizeY());
+	for (int region_y = 0; region_y < GetWaterRegionMapSizeY(); region_y++) {
+		for (int region_x = 0; region_x < GetWaterRegionMapSizeX(); region_x++) {
+			_water_regions.emplace_back(region_x, region_y);
+		}
+	}
+}
+
+/**
+ * Check whether the data of the water regions that are in use still matches
+ * the map. A mismatch means an invalidation is missing, which could make
+ * ships of clients that joined later take different routes.
+ */
+void CheckWaterRegionCaches()
+{
+	for (const WaterRegion &region : _water_regions) {
+		if (!region.IsInitialized()) continue;
+
+		WaterRegion fresh = region;
+		fresh.ForceUpdate();
+		if (!fresh.HasSameData(region)) {
+			const TWaterRegionIndex index = static_cast<TWaterRegionIndex>(&region - _water_regions.data());
+			Debug(desync, 2, "water region mismatch: region {}", index);
+		}
+	}
+}
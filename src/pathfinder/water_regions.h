@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file water_regions.h Handles dividing the water in the map into regions to assist pathfinding. */
+
+#ifndef WATER_REGIONS_H
+#define WATER_REGIONS_H
+
+#include "../tile_type.h"
+#include "../direction_type.h"
+
+using TWaterRegionPatchLabel = uint8_t;
+using TWaterRegionIndex = uint;
+
+constexpr int WATER_REGION_EDGE_LENGTH = 16; ///< Number of tiles along the edge of a water region.
+constexpr int WATER_REGION_NUMBER_OF_TILES = WATER_REGION_EDGE_LENGTH * WATER_REGION_EDGE_LENGTH; ///< Number of tiles in a water region.
+
+constexpr TWaterRegionPatchLabel INVALID_WATER_REGION_PATCH = 0; ///< Label of tiles without any water tracks.
+
+/**
+ * Describes a single interconnected patch of water within a particular water region.
+ * Tiles of the same patch can be reached from each other without leaving the region.
+ */
+struct WaterRegionPatchDesc {
+	int x; ///< The X coordinate of the water region, i.e. X = 2 is the 3rd water region along the X-axis.
+	int y; ///< The Y coordinate of the water region, i.e. Y = 2 is the 3rd water region along the Y-axis.
+	TWaterRegionPatchLabel label; ///< Unique label identifying the patch within the region.
+
+	bool operator==(const WaterRegionPatchDesc &other) const { return x == other.x && y == other.y && label == other.label; }
+	bool operator!=(const WaterRegionPatchDesc &other) const { return !(*this == other); }
+};
+
+/**
+ * Callback for VisitWaterRegionPatchNeighbors.
+ * @param neighbor The neighboring water region patch.
+ */
+using TVisitWaterRegionPatchCallBack = std::function<void(const WaterRegionPatchDesc &neighbor)>;
+
+int CalculateWaterRegionPatchHash(const WaterRegionPatchDesc &water_region_patch);
+
+TileIndex GetWaterRegionCenterTile(const WaterRegionPatchDesc &water_region_patch);
+
+WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
+
+void InvalidateWaterRegion(TileIndex tile);
+
+void VisitWaterRegionPatchNeighbors(const WaterRegionPatchDesc &water_region_patch, TVisitWaterRegionPatchCallBack &callback);
+
+void AllocateWaterRegions();
+
+void CheckWaterRegionCaches();
+
+#endif /* WATER_REGIONS_H */
@@ -10,60 +10,183 @@
 #ifndef NODELIST_HPP
 #define NODELIST_HPP
 
-#include "../../misc/array.hpp"
+#include "../../core/format.hpp"
 #include "../../misc/hashtable.hpp"
 #include "../../misc/binaryheap.hpp"
 
+/**
+ * Storage of the nodes of a search. Nodes are allocated in blocks, and
+ * resetting the arena makes all blocks available again without freeing them,
+ * so a search usually allocates nothing when the arena has been used before.
+ * Nodes are not constructed again when they are reused; they are initialised
+ * by Set() like a node taken from fresh memory.
+ */
+template <class Titem_>
+class CNodeArenaT {
+public:
+	static constexpr uint BLOCK_SIZE = 256; ///< Number of nodes allocated at once.
+
+protected:
+	std::vector<std::unique_ptr<Titem_[]>> m_blocks; ///< The blocks of nodes.
+	uint m_num_items = 0;                            ///< Number of nodes in use.
+
+public:
+	static_assert(std::is_trivially_destructible_v<Titem_>, "nodes are reused without being destroyed");
+
+	/** Return actual number of items */
+	inline uint Length() const
+	{
+		return m_num_items;
+	}
+
+	/** allocate new item, reusing the memory of an item of an earlier search when possible */
+	inline Titem_ *Append()
+	{
+		if (m_num_items == m_blocks.size() * BLOCK_SIZE) m_blocks.emplace_back(new Titem_[BLOCK_SIZE]);
+		Titem_ *item = &m_blocks[m_num_items / BLOCK_SIZE][m_num_items % BLOCK_SIZE];
+		m_num_items++;
+		return item;
+	}
+
+	/** Make all items available again, but keep the memory */
+	inline void Reset()
+	{
+		m_num_items = 0;
+	}
+
+	/**
+	 * Make all items available again, and give back memory when there are more items than wanted.
+	 * @param max_items The most items to keep memory for.
+	 */
+	inline void Shrink(uint max_items)
+	{
+		if (m_blocks.size() * BLOCK_SIZE > max_items) m_blocks.resize(max_items / BLOCK_SIZE);
+		m_num_items = 0;
+	}
+
+	/** indexed access (non-const) */
+	inline Titem_ &operator[](uint index)
+	{
+		return m_blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+	}
+
+	/** indexed access (const) */
+	inline const Titem_ &operator[](uint index) const
+	{
+		return m_blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+	}
+
+	/**
+	 * Helper for creating a human readable output of this data.
+	 * @param dmp The location to dump to.
+	 */
+	template <typename D> void Dump(D &dmp) const
+	{
+		dmp.WriteValue("capacity", m_blocks.size() * BLOCK_SIZE);
+		dmp.WriteValue("num_items", m_num_items);
+		for (uint i = 0; i < m_num_items; i++) {
+			dmp.WriteStructT(fmt::format("item[{}]", i), &(*this)[i]);
+		}
+	}
+};
+
 /**
  * Hash table based node list multi-container class.
  *  Implements open list, closed list and priority queue for A-star
  *  path finder.
+ *
+ *  Open and closed nodes are kept in one hash table with open addressing.
+ *  A key stays in the table once added, and only its state changes when
+ *  its node is opened, closed or replaced. The memory of the nodes and
+ *  the table is kept in a pool per thread when the list is destroyed, so
+ *  the next search on that thread can reuse it.
  */
 template <class Titem_, int Thash_bits_open_, int Thash_bits_closed_>
 class CNodeList_HashTableT {
 public:
 	typedef Titem_ Titem;                                        ///< Make #Titem_ visible from outside of class.
 	typedef typename Titem_::Key Key;                            ///< Make Titem_::Key a property of this class.
-	typedef SmallArray<Titem_, 65536, 256> CItemArray;           ///< Type that we will use as item container.
-	typedef CHashTableT<Titem_, Thash_bits_open_  > COpenList;   ///< How pointers to open nodes will be stored.
-	typedef CHashTableT<Titem_, Thash_bits_closed_> CClosedList; ///< How pointers to closed nodes will be stored.
+	typedef CNodeArenaT<Titem_> CItemArray;                      ///< Type that we will use as item container.
 	typedef CBinaryHeapT<Titem_> CPriorityQueue;                 ///< How the priority queue will be managed.
 
+	static constexpr uint MAX_POOLED_ITEMS = 1 << 16;            ///< Most nodes a pooled list keeps memory for.
+
 protected:
-	CItemArray      m_arr;        ///< Here we store full item data (Titem_).
-	COpenList       m_open;       ///< Hash table of pointers to open item data.
-	CClosedList     m_closed;     ///< Hash table of pointers to closed item data.
-	CPriorityQueue  m_open_queue; ///< Priority queue of pointers to open item data.
-	Titem          *m_new_node;   ///< New open node under construction.
+	/** State of the node of a key. */
+	enum class NodeState : uint8_t {
+		None,   ///< The key has no node in the open or closed list.
+		Open,   ///< The node is in the open list.
+		Closed, ///< The node is in the closed list.
+	};
+
+	/** Node of a key, and whether it is open or closed. */
+	struct Entry {
+		Titem_ *item = nullptr;            ///< The node.
+		NodeState state = NodeState::None; ///< Its state.
+	};
+
+	typedef COpenHashTableT<Key, Entry> CNodeHash;               ///< How pointers to open and closed nodes will be stored.
+
+	/** Memory of a node list kept for the next search. */
+	struct Storage {
+		CItemArray arr;  ///< Memory of the nodes.
+		CNodeHash nodes; ///< Memory of the hash table.
+	};
+
+	CItemArray      m_arr;          ///< Here we store full item data (Titem_).
+	CNodeHash       m_nodes;        ///< Hash table of pointers to open and closed item data.
+	CPriorityQueue  m_open_queue;   ///< Priority queue of pointers to open item data.
+	Titem          *m_new_node;     ///< New open node under construction.
+	int             m_open_count;   ///< Number of open nodes.
+	int             m_closed_count; ///< Number of closed nodes.
+
+	/** The storage kept for the next search on this thread; one for every list that was alive at once. */
+	static std::vector<Storage> &GetPool()
+	{
+		static thread_local std::vector<Storage> pool;
+		return pool;
+	}
 
 public:
 	/** default constructor */
-	CNodeList_HashTableT() : m_open_queue(2048)
+	CNodeList_HashTableT() : m_nodes(1 << std::max(Thash_bits_open_, Thash_bits_closed_)), m_open_queue(2048)
 	{
 		m_new_node = nullptr;
+		m_open_count = 0;
+		m_closed_count = 0;
+
+		std::vector<Storage> &pool = GetPool();
+		if (!pool.empty()) {
+			m_arr = std::move(pool.back().arr);
+			m_nodes = std::move(pool.back().nodes);
+			pool.pop_back();
+		}
 	}
 
 	/** destructor */
 	~CNodeList_HashTableT()
 	{
+		m_arr.Shrink(MAX_POOLED_ITEMS);
+		m_nodes.Shrink(MAX_POOLED_ITEMS * 2);
+		GetPool().push_back({std::move(m_arr), std::move(m_nodes)});
 	}
 
 	/** return number of open nodes */
 	inline int OpenCount()
 	{
-		return m_open.Count();
+		return m_open_count;
 	}
 
 	/** return number of closed nodes */
 	inline int ClosedCount()
 	{
-		return m_closed.Count();
+		return m_closed_count;
 	}
 
 	/** allocate new data item from m_arr */
 	inline Titem_ *CreateNewNode()
 	{
-		if (m_new_node == nullptr) m_new_node = m_arr.AppendC();
+		if (m_new_node == nullptr) m_new_node = m_arr.Append();
 		return m_new_node;
 	}
 
@@ -77,11 +200,14 @@ public:
 		/* TODO: do we need to store best nodes found in some extra list/array? Probably not now. */
 	}
 
-	/** insert given item as open node (into m_open and m_open_queue) */
+	/** insert given item as open node (into m_nodes and m_open_queue) */
 	inline void InsertOpenNode(Titem_ &item)
 	{
-		assert(m_closed.Find(item.GetKey()) == nullptr);
-		m_open.Push(item);
+		Entry &entry = m_nodes.FindOrInsert(item.GetKey());
+		assert(entry.state == NodeState::None);
+		entry.item = &item;
+		entry.state = NodeState::Open;
+		m_open_count++;
 		m_open_queue.Include(&item);
 		if (&item == m_new_node) {
 			m_new_node = nullptr;
@@ -102,7 +228,10 @@ public:
 	{
 		if (!m_open_queue.IsEmpty()) {
 			Titem_ *item = m_open_queue.Shift();
-			m_open.Pop(*item);
+			Entry *entry = m_nodes.Find(item->GetKey());
+			assert(entry != nullptr && entry->state == NodeState::Open);
+			entry->state = NodeState::None;
+			m_open_count--;
 			return item;
 		}
 		return nullptr;
@@ -111,14 +240,18 @@ public:
 	/** return the open node specified by a key or nullptr if not found */
 	inline Titem_ *FindOpenNode(const Key &key)
 	{
-		Titem_ *item = m_open.Find(key);
-		return item;
+		Entry *entry = m_nodes.Find(key);
+		return (entry != nullptr && entry->state == NodeState::Open) ? entry->item : nullptr;
 	}
 
 	/** remove and return the open node specified by a key */
 	inline Titem_& PopOpenNode(const Key &key)
 	{
-		Titem_ &item = m_open.Pop(key);
+		Entry *entry = m_nodes.Find(key);
+		assert(entry != nullptr && entry->state == NodeState::Open);
+		entry->state = NodeState::None;
+		m_open_count--;
+		Titem_ &item = *entry->item;
 		uint idxPop = m_open_queue.FindIndex(item);
 		m_open_queue.Remove(idxPop);
 		return item;
@@ -127,15 +260,18 @@ public:
 	/** close node */
 	inline void InsertClosedNode(Titem_ &item)
 	{
-		assert(m_open.Find(item.GetKey()) == nullptr);
-		m_closed.Push(item);
+		Entry &entry = m_nodes.FindOrInsert(item.GetKey());
+		assert(entry.state == NodeState::None);
+		entry.item = &item;
+		entry.state = NodeState::Closed;
+		m_closed_count++;
 	}
 
 	/** return the closed node specified by a key or nullptr if not found */
 	inline Titem_ *FindClosedNode(const Key &key)
 	{
-		Titem_ *item = m_closed.Find(key);
-		return item;
+		Entry *entry = m_nodes.Find(key);
+		return (entry != nullptr && entry->state == NodeState::Closed) ? entry->item : nullptr;
 	}
 
 	/** The number of items. */
@@ -163,6 +163,12 @@ public:
 		return (m_pBestDestNode != nullptr) ? m_pBestDestNode : m_pBestIntermediateNode;
 	}
 
+	/** Return the number of nodes the last search expanded. */
+	inline int GetClosedCount()
+	{
+		return m_nodes.ClosedCount();
+	}
+
 	/**
 	 * Calls NodeList::CreateNewNode() - allocates new node that can be filled and used
 	 *  as argument for AddStartupNode() or AddNewNode()
@@ -19,4 +19,34 @@
  */
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track);
 
+/** Statistics of the caches of rail segment costs, since OpenTTD started. */
+struct YapfSegmentCacheStats {
+	uint64_t hits;        ///< Number of segments whose cost was found in a cache.
+	uint64_t misses;      ///< Number of segments whose cost had to be calculated.
+	uint64_t invalidated; ///< Number of cached segments dropped because one of their tiles changed.
+	uint64_t flushes;     ///< Number of times a whole cache was dropped.
+};
+
+YapfSegmentCacheStats YapfGetSegmentCacheStats();
+
+/**
+ * Use this function to notify YAPF that the road layout has changed.
+ * @param tile the tile that is changed, or INVALID_TILE to drop all shared road routes
+ */
+void YapfNotifyRoadLayoutChange(TileIndex tile);
+
+/**
+ * Use this function to notify YAPF that the water tracks of a tile may have changed.
+ * @param tile the tile that is changed
+ */
+void YapfNotifyWaterLayoutChange(TileIndex tile);
+
+/** Statistics of the route cache shared by all road vehicles, since OpenTTD started. */
+struct YapfRoadRouteCacheStats {
+	uint64_t hits;   ///< Number of times a road vehicle could reuse a route found for another vehicle.
+	uint64_t misses; ///< Number of times a road vehicle had to search for a route.
+};
+
+YapfRoadRouteCacheStats YapfGetRoadRouteCacheStats();
+
 #endif /* YAPF_CACHE_H */
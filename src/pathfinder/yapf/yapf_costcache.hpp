@@ -11,6 +11,10 @@
 #define YAPF_COSTCACHE_HPP
 
 #include "../../timer/timer_game_calendar.h"
+#include "yapf_cache.h"
+
+#include <mutex>
+#include <unordered_map>
 
 /**
  * CYapfSegmentCostCacheNoneT - the formal only yapf cost cache provider that implements
@@ -91,19 +95,81 @@ public:
 
 
 /**
- * Base class for segment cost cache providers. Contains global counter
- *  of track layout changes and static notification function called whenever
+ * Base class for segment cost cache providers. Contains the list of all
+ *  segment cost caches and static notification function called whenever
  *  the track layout changes. It is implemented as base class because it needs
- *  to be shared between all rail YAPF types (one shared counter, one notification
- *  function.
+ *  to be shared between all rail YAPF types (one list of caches, one notification
+ *  function). Each thread running pathfinders has its own caches; they are only
+ *  notified while none of the threads is searching.
  */
 struct CSegmentCostCacheBase
 {
-	static int   s_rail_change_counter;
+	YapfSegmentCacheStats m_stats = {}; ///< Statistics of this cache.
+
+	virtual ~CSegmentCostCacheBase()
+	{
+		std::lock_guard<std::mutex> guard(GetCachesMutex());
+		std::vector<CSegmentCostCacheBase *> &caches = GetCaches();
+		caches.erase(std::find(caches.begin(), caches.end(), this));
+	}
+
+	/**
+	 * Drop the cached segments that contain the given tile, or that end next to it.
+	 * @param tile The changed tile.
+	 */
+	virtual void InvalidateTile(TileIndex tile) = 0;
+
+	/** Drop all cached segments the next time the cache is used. */
+	virtual void RequestFlush() = 0;
 
 	static void NotifyTrackLayoutChange(TileIndex tile, Track track)
 	{
-		s_rail_change_counter++;
+		std::lock_guard<std::mutex> guard(GetCachesMutex());
+		for (CSegmentCostCacheBase *cache : GetCaches()) {
+			if (tile == INVALID_TILE) {
+				cache->RequestFlush();
+			} else {
+				cache->InvalidateTile(tile);
+			}
+		}
+	}
+
+	/**
+	 * Get the statistics of all segment cost caches together.
+	 * @return The summed statistics.
+	 */
+	static YapfSegmentCacheStats GetTotalStats()
+	{
+		std::lock_guard<std::mutex> guard(GetCachesMutex());
+		YapfSegmentCacheStats total = {};
+		for (const CSegmentCostCacheBase *cache : GetCaches()) {
+			total.hits += cache->m_stats.hits;
+			total.misses += cache->m_stats.misses;
+			total.invalidated += cache->m_stats.invalidated;
+			total.flushes += cache->m_stats.flushes;
+		}
+		return total;
+	}
+
+protected:
+	inline CSegmentCostCacheBase()
+	{
+		std::lock_guard<std::mutex> guard(GetCachesMutex());
+		GetCaches().push_back(this);
+	}
+
+	/** Get all segment cost caches, so they can be notified about changes of the track layout. */
+	static std::vector<CSegmentCostCacheBase *> &GetCaches()
+	{
+		static std::vector<CSegmentCostCacheBase *> caches;
+		return caches;
+	}
+
+	/** Get the lock for the list of caches, which threads add their caches to. */
+	static std::mutex &GetCachesMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
 	}
 };
 
@@ -121,6 +187,7 @@ struct CSegmentCostCacheBase
 template <class Tsegment>
 struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 	static const int C_HASH_BITS = 14;
+	static const uint C_MIN_INVALIDATED_FOR_FLUSH = 1024; ///< Minimum number of invalidated segments before they are cleaned up.
 
 	typedef CHashTableT<Tsegment, C_HASH_BITS> HashTable;
 	typedef SmallArray<Tsegment> Heap;
@@ -128,14 +195,65 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 
 	HashTable    m_map;
 	Heap         m_heap;
+	std::unordered_map<uint32_t, std::vector<Tsegment *>> m_tile_segments; ///< Segments that depend on each tile; may still refer to invalidated segments.
+	uint         m_num_invalidated; ///< Number of segments in #m_heap that were removed from #m_map.
+	bool         m_flush_requested; ///< Whether all segments are to be dropped the next time the cache is used.
 
-	inline CSegmentCostCacheT() {}
+	inline CSegmentCostCacheT() : m_num_invalidated(0), m_flush_requested(false) {}
 
 	/** flush (clear) the cache */
 	inline void Flush()
 	{
 		m_map.Clear();
 		m_heap.Clear();
+		m_tile_segments.clear();
+		m_num_invalidated = 0;
+		m_flush_requested = false;
+		m_stats.flushes++;
+	}
+
+	/**
+	 * Flush the cache when requested, or when most of its memory is taken by
+	 * invalidated segments. Invalidated segments are not freed right away, as
+	 * nodes of a running search may still point to them.
+	 */
+	inline void FlushIfNeeded()
+	{
+		if (m_flush_requested || (m_num_invalidated >= C_MIN_INVALIDATED_FOR_FLUSH && m_num_invalidated * 2 >= m_heap.Length())) Flush();
+	}
+
+	void InvalidateTile(TileIndex tile) override
+	{
+		auto it = m_tile_segments.find(static_cast<uint32_t>(tile));
+		if (it == m_tile_segments.end()) return;
+
+		for (Tsegment *segment : it->second) {
+			/* The segment is already gone when another of its tiles changed before. */
+			if (m_map.TryPop(*segment)) {
+				m_num_invalidated++;
+				m_stats.invalidated++;
+			}
+		}
+		m_tile_segments.erase(it);
+	}
+
+	void RequestFlush() override
+	{
+		m_flush_requested = true;
+	}
+
+	/**
+	 * Remember the tiles a segment depends on, so it is invalidated when one of them changes.
+	 * @param segment The segment whose cost was just calculated.
+	 * @param tiles The tiles of the segment.
+	 */
+	inline void AddSegmentTiles(Tsegment &segment, const std::vector<TileIndex> &tiles)
+	{
+		for (TileIndex tile : tiles) {
+			std::vector<Tsegment *> &segments = m_tile_segments[static_cast<uint32_t>(tile)];
+			/* Tiles are often repeated by consecutive calls for the same segment. */
+			if (segments.empty() || segments.back() != &segment) segments.push_back(&segment);
+		}
 	}
 
 	inline Tsegment& Get(Key &key, bool *found)
@@ -181,14 +299,10 @@ protected:
 
 	inline static Cache& stGetGlobalCache()
 	{
-		static int last_rail_change_counter = 0;
-		static Cache C;
+		static thread_local Cache C;
 
 		/* delete the cache sometimes... */
-		if (last_rail_change_counter != Cache::s_rail_change_counter) {
-			last_rail_change_counter = Cache::s_rail_change_counter;
-			C.Flush();
-		}
+		C.FlushIfNeeded();
 		return C;
 	}
 
@@ -206,9 +320,25 @@ public:
 		bool found;
 		CachedData &item = m_global_cache.Get(key, &found);
 		Yapf().ConnectNodeToCachedData(n, item);
+		if (found) {
+			m_global_cache.m_stats.hits++;
+		} else {
+			m_global_cache.m_stats.misses++;
+		}
 		return found;
 	}
 
+	/**
+	 * Called by the cost calculation after it calculated the cost of a segment.
+	 *  Remembers the tiles of globally cached segments, so the segment can be
+	 *  dropped from the cache as soon as one of these tiles changes.
+	 */
+	inline void PfNodeCacheStoreTiles(CachedData &segment, const std::vector<TileIndex> &tiles)
+	{
+		if (m_global_cache.m_map.Find(segment.GetKey()) != &segment) return;
+		m_global_cache.AddSegmentTiles(segment, tiles);
+	}
+
 	/**
 	 * Called by YAPF to flush the cached segment cost data back into cache storage.
 	 *  Current cache implementation doesn't use that.
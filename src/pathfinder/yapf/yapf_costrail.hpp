@@ -56,6 +56,7 @@ protected:
 	int m_max_cost;
 	bool m_disable_cache;
 	std::vector<int> m_sig_look_ahead_costs;
+	std::vector<TileIndex> m_segment_tiles; ///< Tiles the cost of the segment being calculated depends on.
 
 public:
 	bool          m_stopped_on_first_two_way_signal;
@@ -323,6 +324,8 @@ public:
 
 		TrackFollower tf_local(v, Yapf().GetCompatibleRailTypes());
 
+		m_segment_tiles.clear();
+
 		if (!has_parent) {
 			/* We will jump to the middle of the cost calculator assuming that segment cache is not used. */
 			assert(!is_cached_segment);
@@ -369,6 +372,18 @@ public:
 
 no_entry_cost: // jump here at the beginning if the node has no parent (it is the first node)
 
+			/* Remember the tiles of the segment, so its cached cost is dropped when one of them changes. */
+			m_segment_tiles.push_back(cur.tile);
+			if (tf->m_is_station) {
+				/* The skipped platform tiles are part of the segment as well. */
+				TileIndexDiff diff = TileOffsByDiagDir(ReverseDiagDir(TrackdirToExitdir(cur.td)));
+				TileIndex tile = cur.tile;
+				for (int i = 0; i < tf->m_tiles_skipped; i++) {
+					tile = TILE_ADD(tile, diff);
+					m_segment_tiles.push_back(tile);
+				}
+			}
+
 			/* All other tile costs will be calculated here. */
 			segment_cost += Yapf().OneTileCost(cur.tile, cur.td);
 
@@ -569,6 +584,10 @@ no_entry_cost: // jump here at the beginning if the node has no parent (it is th
 			segment.m_end_segment_reason = end_segment_reason & ESRB_CACHED_MASK;
 			/* Save end of segment back to the node. */
 			n.SetLastTileTrackdir(cur.tile, cur.td);
+			/* The end of the segment also depends on the tile after it, e.g. when
+			 * building track there turns it into a choice or removes a dead end. */
+			if (tf_local.m_new_tile != INVALID_TILE) m_segment_tiles.push_back(tf_local.m_new_tile);
+			Yapf().PfNodeCacheStoreTiles(segment, m_segment_tiles);
 		}
 
 		/* Do we have an excuse why not to continue pathfinding in this direction? */
@@ -119,6 +119,9 @@ protected:
 	TrackdirBits m_destTrackdirs;
 	StationID    m_dest_station_id;
 	bool         m_any_depot;
+	bool         m_use_landmarks = false;       ///< Whether the landmark estimate is used.
+	YapfLandmarks::Bounds m_landmark_bounds;   ///< Distances from the landmarks to the destination.
+	std::shared_ptr<const YapfRailJunctionGraph::Distances> m_junction_distances; ///< Least costs from the junctions to the destination, if known.
 
 	/** to access inherited path finder */
 	Tpf& Yapf()
@@ -161,6 +164,27 @@ public:
 				break;
 		}
 		CYapfDestinationRailBase::SetDestination(v);
+
+		/* Any depot may be the destination, so there are no distances to the destination to compare. */
+		m_use_landmarks = !m_any_depot && _rail_landmarks.IsAvailable();
+		if (m_use_landmarks) {
+			m_landmark_bounds = _rail_landmarks.GetBounds(m_dest_station_id != INVALID_STATION ? BaseStation::Get(m_dest_station_id)->train_station : TileArea(m_destTile, 1, 1));
+		}
+
+		m_junction_distances = nullptr;
+		if (!m_any_depot && _rail_junction_graph.IsAvailable()) {
+			if (m_dest_station_id != INVALID_STATION) {
+				m_junction_distances = _rail_junction_graph.GetDistances({m_dest_station_id, INVALID_TILE, TRACKDIR_BIT_NONE});
+			} else {
+				m_junction_distances = _rail_junction_graph.GetDistances({INVALID_STATION, m_destTile, m_destTrackdirs});
+			}
+		}
+	}
+
+	/** Whether the search uses the landmark or junction graph estimate. */
+	inline bool UsesLandmarks() const
+	{
+		return m_use_landmarks || m_junction_distances != nullptr;
 	}
 
 	/** Called by YAPF to detect if node ends in the desired destination */
@@ -209,6 +233,13 @@ public:
 		int dmin = std::min(dx, dy);
 		int dxy = abs(dx - dy);
 		int d = dmin * YAPF_TILE_CORNER_LENGTH + (dxy - 1) * (YAPF_TILE_LENGTH / 2);
+		if (m_use_landmarks || m_junction_distances != nullptr) {
+			if (m_use_landmarks) d = std::max(d, _rail_landmarks.GetEstimate(m_landmark_bounds, tile));
+			if (m_junction_distances != nullptr) d = std::max(d, _rail_junction_graph.GetEstimate(*m_junction_distances, tile, n.GetLastTrackdir()));
+			/* The estimate never decreases along a path; keep it so even if the distances were out of date. */
+			n.m_estimate = std::max(n.m_cost + d, n.m_parent->m_estimate);
+			return true;
+		}
 		n.m_estimate = n.m_cost + d;
 		assert(n.m_estimate >= n.m_parent->m_estimate);
 		return true;
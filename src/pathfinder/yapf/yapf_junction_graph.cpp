@@ -0,0 +1,495 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_junction_graph.cpp Contracted graph of the rail network, for estimating the cost of long routes. */
+
+#include "../../stdafx.h"
+#include "../../base_station_base.h"
+#include "../../debug.h"
+#include "../../landscape.h"
+#include "../../map_func.h"
+#include "../../rail_map.h"
+#include "../../settings_type.h"
+#include "../../station_map.h"
+#include "../../thread.h"
+#include "../../track_func.h"
+#include "../../tunnelbridge.h"
+#include "../../tunnelbridge_map.h"
+#include "../../timer/timer.h"
+#include "../../timer/timer_game_calendar.h"
+#include "../pathfinder_type.h"
+#include "yapf_junction_graph.h"
+#include <queue>
+
+#include "../../safeguards.h"
+
+/** Number of destinations whose distances are kept. */
+static const size_t JUNCTION_GRAPH_CACHE_SIZE = 16;
+
+/** Index of a state that is not in the graph. */
+static const uint32_t INVALID_STATE = UINT32_MAX;
+
+YapfRailJunctionGraph _rail_junction_graph;
+
+/**
+ * Add two costs, without reaching #YapfRailJunctionGraph::UNREACHABLE.
+ * @param a The first cost.
+ * @param b The second cost.
+ * @return The sum.
+ */
+static inline uint32_t AddJunctionCost(uint32_t a, uint32_t b)
+{
+	return a >= YapfRailJunctionGraph::UNREACHABLE - 1 - b ? YapfRailJunctionGraph::UNREACHABLE - 1 : a + b;
+}
+
+/**
+ * Get the trackdirs of the track on a tile, whatever the state of its signals.
+ * @param tile The tile.
+ * @return The trackdirs.
+ */
+static TrackdirBits GetRailTrackdirs(TileIndex tile)
+{
+	switch (GetTileType(tile)) {
+		case MP_RAILWAY:
+		case MP_ROAD:
+		case MP_STATION:
+		case MP_TUNNELBRIDGE:
+			return TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, 0));
+
+		default:
+			return TRACKDIR_BIT_NONE;
+	}
+}
+
+/**
+ * Find the state of a trackdir on a tile.
+ * @param tile The tile.
+ * @param td The trackdir.
+ * @return The index of the state, or #INVALID_STATE when the graph has no such state.
+ */
+uint32_t YapfRailJunctionGraph::Graph::FindState(TileIndex tile, Trackdir td) const
+{
+	auto it = std::lower_bound(this->tiles.begin(), this->tiles.end(), tile);
+	if (it == this->tiles.end() || *it != tile) return INVALID_STATE;
+
+	size_t index = it - this->tiles.begin();
+	if (!HasBit(this->trackdirs[index], td)) return INVALID_STATE;
+	return this->first_state[index] + CountBits(this->trackdirs[index] & (((uint)1 << td) - 1));
+}
+
+YapfRailJunctionGraph::YapfRailJunctionGraph()
+{
+	this->Clear();
+}
+
+YapfRailJunctionGraph::~YapfRailJunctionGraph()
+{
+	if (this->thread.joinable()) this->thread.join();
+}
+
+/** Forget the graph; a new one is built at the start of the next day. */
+void YapfRailJunctionGraph::Clear()
+{
+	this->Join();
+
+	this->usable = false;
+	this->job_running = false;
+	this->changed = true;
+	this->rail_tiles.clear();
+	this->pending.clear();
+	this->graph.reset();
+	this->next.reset();
+	this->cache.clear();
+}
+
+/**
+ * Note a change of the track layout of a tile; the graph isn't used until it is built anew.
+ * @param tile The changed tile.
+ */
+void YapfRailJunctionGraph::NotifyTileChange(TileIndex tile)
+{
+	this->usable = false;
+	this->changed = true;
+	if (!this->rail_tiles.empty()) this->pending.push_back(tile);
+}
+
+/** Take the graph built since yesterday into use, and start building a new one if the layout changed. */
+void YapfRailJunctionGraph::OnNewDay()
+{
+	if (!_settings_game.pf.yapf.rail_junction_graph) return;
+
+	if (this->job_running) {
+		this->Join();
+		this->job_running = false;
+		if (!this->changed && this->next != nullptr) {
+			this->graph = std::move(this->next);
+			this->cache.clear();
+			this->usable = true;
+			Debug(yapf, 2, "Rail junction graph: {} tiles, {} states, {} junctions, {} edges",
+					this->graph->tiles.size(), this->graph->state_junction.size(), this->graph->first_edge.size() - 1, this->graph->edges.size());
+		}
+		this->next.reset();
+	}
+
+	if (this->changed) this->Start();
+}
+
+/** Get the graph of a loaded game in the same state as where it was saved. */
+void YapfRailJunctionGraph::AfterLoad()
+{
+	if (!_settings_game.pf.yapf.rail_junction_graph) {
+		this->Clear();
+		return;
+	}
+
+	if (this->usable) {
+		/* The layout is still the one the graph was built from. */
+		this->Start();
+		this->Join();
+		this->job_running = false;
+		this->graph = std::move(this->next);
+	} else if (this->job_running && !this->changed) {
+		/* The graph that is being built was started from the current layout. */
+		this->Start();
+	}
+}
+
+/**
+ * Check whether the graph can be used for a search.
+ * @return True when the graph matches the current layout.
+ */
+bool YapfRailJunctionGraph::IsAvailable() const
+{
+	return _settings_game.pf.yapf.rail_junction_graph && this->usable && this->graph != nullptr;
+}
+
+/**
+ * Get the least cost from every junction to a destination.
+ * @param dest The destination.
+ * @return The costs, or nullptr when the destination isn't on a junction.
+ */
+std::shared_ptr<const YapfRailJunctionGraph::Distances> YapfRailJunctionGraph::GetDistances(const Destination &dest)
+{
+	this->cache_clock++;
+	for (CacheEntry &entry : this->cache) {
+		if (entry.dest == dest) {
+			entry.last_used = this->cache_clock;
+			return entry.distances;
+		}
+	}
+
+	const Graph &g = *this->graph;
+	auto distances = std::make_shared<Distances>(g.first_edge.size() - 1, UNREACHABLE);
+	std::vector<uint32_t> seeds;
+
+	if (dest.station != INVALID_STATION) {
+		const BaseStation *st = BaseStation::GetIfValid(dest.station);
+		if (st == nullptr) return nullptr;
+		for (TileIndex tile : st->train_station) {
+			if (!HasStationTileRail(tile) || GetStationIndex(tile) != dest.station) continue;
+			if (!this->AddDestination(*distances, seeds, tile, TrackToTrackdirBits(GetRailStationTrack(tile)))) return nullptr;
+		}
+	} else if (!this->AddDestination(*distances, seeds, dest.tile, dest.trackdirs)) {
+		return nullptr;
+	}
+
+	std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>, std::greater<std::pair<uint32_t, uint32_t>>> queue;
+	for (uint32_t junction : seeds) queue.emplace(0, junction);
+	while (!queue.empty()) {
+		auto [cost, junction] = queue.top();
+		queue.pop();
+		if (cost != (*distances)[junction]) continue;
+
+		for (uint32_t edge = g.first_edge[junction]; edge < g.first_edge[junction + 1]; edge++) {
+			auto [from, edge_cost] = g.edges[edge];
+			uint32_t from_cost = AddJunctionCost(cost, edge_cost);
+			if (from_cost < (*distances)[from]) {
+				(*distances)[from] = from_cost;
+				queue.emplace(from_cost, from);
+			}
+		}
+	}
+
+	if (this->cache.size() >= JUNCTION_GRAPH_CACHE_SIZE) {
+		this->cache.erase(std::min_element(this->cache.begin(), this->cache.end(), [](const CacheEntry &a, const CacheEntry &b) { return a.last_used < b.last_used; }));
+	}
+	this->cache.push_back({dest, distances, this->cache_clock});
+	return distances;
+}
+
+/**
+ * Get the least cost from a state to the destination.
+ * @param distances The costs from the junctions to the destination, see #GetDistances.
+ * @param tile The tile of the state.
+ * @param td The trackdir of the state.
+ * @return The least cost, or 0 when it isn't known.
+ */
+int YapfRailJunctionGraph::GetEstimate(const Distances &distances, TileIndex tile, Trackdir td) const
+{
+	uint32_t state = this->graph->FindState(tile, td);
+	if (state == INVALID_STATE) return 0;
+
+	uint32_t cost = distances[this->graph->state_junction[state]];
+	if (cost == UNREACHABLE) return 0;
+	return (int)std::min<uint32_t>(AddJunctionCost(cost, this->graph->state_cost[state]), INT32_MAX / 2);
+}
+
+/**
+ * Add the junctions of a destination tile as seeds of the search for the least costs.
+ * @param distances The costs to set to zero for the destination junctions.
+ * @param seeds The destination junctions.
+ * @param tile The destination tile.
+ * @param trackdirs The destination trackdirs on the tile.
+ * @return False when one of the destination states isn't a junction.
+ */
+bool YapfRailJunctionGraph::AddDestination(Distances &distances, std::vector<uint32_t> &seeds, TileIndex tile, TrackdirBits trackdirs) const
+{
+	for (uint bit : SetBitIterator(trackdirs)) {
+		uint32_t state = this->graph->FindState(tile, (Trackdir)bit);
+		if (state == INVALID_STATE) continue;
+		if (this->graph->state_cost[state] != 0) return false;
+
+		uint32_t junction = this->graph->state_junction[state];
+		if (distances[junction] != 0) {
+			distances[junction] = 0;
+			seeds.push_back(junction);
+		}
+	}
+	return true;
+}
+
+/** Bring the bits of the tiles with track up to date, scanning the whole map when they aren't known yet. */
+void YapfRailJunctionGraph::UpdateRailTiles()
+{
+	if (this->rail_tiles.empty()) {
+		this->rail_tiles.assign(CeilDiv(Map::Size(), 64), 0);
+		for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+			if (GetRailTrackdirs(tile) != TRACKDIR_BIT_NONE) SetBit(this->rail_tiles[tile / 64], tile % 64);
+		}
+	} else {
+		for (TileIndex tile : this->pending) {
+			if (GetRailTrackdirs(tile) != TRACKDIR_BIT_NONE) {
+				SetBit(this->rail_tiles[tile / 64], tile % 64);
+			} else {
+				ClrBit(this->rail_tiles[tile / 64], tile % 64);
+			}
+		}
+	}
+	this->pending.clear();
+}
+
+/** Take a snapshot of the layout and build the next graph from it on a background thread. */
+void YapfRailJunctionGraph::Start()
+{
+	this->Join();
+	this->UpdateRailTiles();
+
+	this->snapshot.clear();
+	for (size_t word = 0; word < this->rail_tiles.size(); word++) {
+		for (uint64_t bits = this->rail_tiles[word]; bits != 0; bits &= bits - 1) {
+			TileIndex tile = (TileIndex)(word * 64 + FindFirstBit(bits));
+
+			SnapshotTile &st = this->snapshot.emplace_back();
+			st.tile = tile;
+			st.other_end = INVALID_TILE;
+			st.trackdirs = GetRailTrackdirs(tile);
+			st.skipped = 0;
+			st.direction = INVALID_DIAGDIR;
+			st.depot = false;
+			st.junction = false;
+
+			if (IsTileType(tile, MP_TUNNELBRIDGE)) {
+				st.other_end = GetOtherTunnelBridgeEnd(tile);
+				st.skipped = GetTunnelBridgeLength(tile, st.other_end);
+				st.direction = GetTunnelBridgeDirection(tile);
+			} else if (IsRailDepotTile(tile)) {
+				st.direction = GetRailDepotDirection(tile);
+				st.depot = true;
+				st.junction = true;
+			} else if (HasStationTileRail(tile)) {
+				st.junction = true;
+			}
+		}
+	}
+
+	this->changed = false;
+	this->job_running = true;
+	this->next = std::make_unique<Graph>();
+	if (!StartNewThread(&this->thread, "ottd:junctions", [this]() { this->BuildGraph(); })) {
+		/* No threads available, so build the graph right away. */
+		this->BuildGraph();
+	}
+}
+
+/** Wait for the background thread, if any. */
+void YapfRailJunctionGraph::Join()
+{
+	if (this->thread.joinable()) this->thread.join();
+}
+
+/**
+ * Call a function for each state a train can go to from a state, as far as the snapshot tells.
+ * @param g The graph being built, for the index of the states.
+ * @param index Index of the tile of the state in the snapshot.
+ * @param td Trackdir of the state.
+ * @param func Function to call with the next state and the least cost of going there.
+ */
+template <typename F>
+void YapfRailJunctionGraph::ForEachSuccessor(const Graph &g, size_t index, Trackdir td, F func) const
+{
+	const SnapshotTile &st = this->snapshot[index];
+	const DiagDirection exitdir = TrackdirToExitdir(td);
+
+	if (st.depot && exitdir != st.direction) {
+		/* Trains turn around in depots. */
+		func(g.first_state[index] + CountBits(st.trackdirs & (((uint)1 << ReverseTrackdir(td)) - 1)), 0);
+		return;
+	}
+
+	TileIndex next_tile;
+	uint32_t cost = 0;
+	bool wormhole = st.other_end != INVALID_TILE && exitdir == st.direction;
+	if (wormhole) {
+		next_tile = st.other_end;
+		cost = st.skipped * YAPF_TILE_LENGTH;
+	} else {
+		next_tile = AddTileIndexDiffCWrap(st.tile, TileIndexDiffCByDiagDir(exitdir));
+		if (next_tile == INVALID_TILE) return;
+	}
+
+	auto it = std::lower_bound(g.tiles.begin(), g.tiles.end(), next_tile);
+	if (it == g.tiles.end() || *it != next_tile) return;
+	size_t next_index = it - g.tiles.begin();
+	const SnapshotTile &next = this->snapshot[next_index];
+
+	/* Tunnels and bridges can't be entered from the side of their wormhole, nor depots from their back. */
+	if (!wormhole && next.other_end != INVALID_TILE && next.direction == ReverseDiagDir(exitdir)) return;
+	if (next.depot && next.direction != ReverseDiagDir(exitdir)) return;
+
+	for (uint bit : SetBitIterator(next.trackdirs & DiagdirReachesTrackdirs(exitdir))) {
+		uint32_t state = g.first_state[next_index] + CountBits(next.trackdirs & (((uint)1 << bit) - 1));
+		func(state, cost + (IsDiagonalTrackdir((Trackdir)bit) ? YAPF_TILE_LENGTH : YAPF_TILE_CORNER_LENGTH));
+	}
+}
+
+/** Build the next graph from the snapshot. Runs on the background thread. */
+void YapfRailJunctionGraph::BuildGraph()
+{
+	Graph &g = *this->next;
+	const size_t num_tiles = this->snapshot.size();
+
+	g.tiles.resize(num_tiles);
+	g.trackdirs.resize(num_tiles);
+	g.first_state.resize(num_tiles + 1);
+	uint32_t num_states = 0;
+	for (size_t i = 0; i < num_tiles; i++) {
+		g.tiles[i] = this->snapshot[i].tile;
+		g.trackdirs[i] = this->snapshot[i].trackdirs;
+		g.first_state[i] = num_states;
+		num_states += CountBits(this->snapshot[i].trackdirs);
+	}
+	g.first_state[num_tiles] = num_states;
+
+	/* Where each state leads to. */
+	std::vector<uint32_t> first_successor(num_states + 1);
+	std::vector<std::pair<uint32_t, uint32_t>> successors;
+	std::vector<bool> is_junction(num_states);
+	for (size_t i = 0; i < num_tiles; i++) {
+		uint32_t state = g.first_state[i];
+		for (uint bit : SetBitIterator(this->snapshot[i].trackdirs)) {
+			first_successor[state] = (uint32_t)successors.size();
+			this->ForEachSuccessor(g, i, (Trackdir)bit, [&successors](uint32_t next, uint32_t cost) {
+				successors.emplace_back(next, cost);
+			});
+			is_junction[state] = this->snapshot[i].junction || successors.size() - first_successor[state] != 1;
+			state++;
+		}
+	}
+	first_successor[num_states] = (uint32_t)successors.size();
+	this->snapshot = {};
+
+	/* Follow the only way on from every other state until a junction. */
+	static const uint32_t UNRESOLVED = UINT32_MAX;
+	static const uint32_t IN_PROGRESS = UINT32_MAX - 1;
+	g.state_junction.assign(num_states, UNRESOLVED);
+	g.state_cost.assign(num_states, 0);
+	for (uint32_t state = 0; state < num_states; state++) {
+		if (is_junction[state]) g.state_junction[state] = state;
+	}
+
+	std::vector<uint32_t> path;
+	for (uint32_t state = 0; state < num_states; state++) {
+		if (g.state_junction[state] != UNRESOLVED) continue;
+
+		path.clear();
+		uint32_t cur = state;
+		while (g.state_junction[cur] == UNRESOLVED) {
+			g.state_junction[cur] = IN_PROGRESS;
+			path.push_back(cur);
+			cur = successors[first_successor[cur]].first;
+		}
+		if (g.state_junction[cur] == IN_PROGRESS) {
+			/* A loop without junctions; make the state where it closes one. */
+			is_junction[cur] = true;
+			g.state_junction[cur] = cur;
+		}
+
+		for (size_t i = path.size(); i-- > 0;) {
+			uint32_t p = path[i];
+			if (is_junction[p]) continue;
+			auto [next, cost] = successors[first_successor[p]];
+			g.state_junction[p] = g.state_junction[next];
+			g.state_cost[p] = AddJunctionCost(cost, g.state_cost[next]);
+		}
+	}
+
+	/* Number the junctions. */
+	std::vector<uint32_t> junction_index(num_states, UINT32_MAX);
+	uint32_t num_junctions = 0;
+	for (uint32_t state = 0; state < num_states; state++) {
+		if (is_junction[state]) junction_index[state] = num_junctions++;
+	}
+	for (uint32_t &junction : g.state_junction) junction = junction_index[junction];
+
+	/* The edges between junctions, grouped by the junction they lead to. */
+	g.first_edge.assign(num_junctions + 1, 0);
+	for (uint32_t state = 0; state < num_states; state++) {
+		if (!is_junction[state]) continue;
+		for (uint32_t s = first_successor[state]; s < first_successor[state + 1]; s++) {
+			g.first_edge[g.state_junction[successors[s].first] + 1]++;
+		}
+	}
+	for (uint32_t junction = 0; junction < num_junctions; junction++) g.first_edge[junction + 1] += g.first_edge[junction];
+
+	g.edges.resize(g.first_edge[num_junctions]);
+	std::vector<uint32_t> fill(g.first_edge.begin(), g.first_edge.end() - 1);
+	for (uint32_t state = 0; state < num_states; state++) {
+		if (!is_junction[state]) continue;
+		for (uint32_t s = first_successor[state]; s < first_successor[state + 1]; s++) {
+			auto [next, cost] = successors[s];
+			g.edges[fill[g.state_junction[next]]++] = { g.state_junction[state], AddJunctionCost(cost, g.state_cost[next]) };
+		}
+	}
+}
+
+/** Forget the graph, e.g. when starting a new game. */
+void InitializeYapfJunctionGraph()
+{
+	_rail_junction_graph.Clear();
+}
+
+/** Rebuild the graph of a loaded game. */
+void AfterLoadYapfJunctionGraph()
+{
+	_rail_junction_graph.AfterLoad();
+}
+
+/** Build the graph anew once a day when the layout changed. */
+static IntervalTimer<TimerGameCalendar> _yapf_junction_graph_daily({TimerGameCalendar::DAY, TimerGameCalendar::Priority::NONE}, [](auto)
+{
+	_rail_junction_graph.OnNewDay();
+});
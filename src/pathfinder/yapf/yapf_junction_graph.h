@@ -0,0 +1,126 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_junction_graph.h Contracted graph of the rail network, for estimating the cost of long routes. */
+
+#ifndef YAPF_JUNCTION_GRAPH_H
+#define YAPF_JUNCTION_GRAPH_H
+
+#include "../../direction_type.h"
+#include "../../station_type.h"
+#include "../../tile_type.h"
+#include "../../track_type.h"
+#include <memory>
+#include <thread>
+
+/**
+ * The rail network contracted to its junctions. A state is a trackdir on a
+ * tile; a junction is a state from which more or less than one way leads on,
+ * or a state on a station, waypoint or depot tile. Every other state leads to
+ * exactly one junction, so the least cost from any state to a destination
+ * follows from the least costs between junctions.
+ *
+ * Costs are lower bounds of what YAPF charges for the same route: signals,
+ * owners, rail types and penalties are ignored and every tile costs its base
+ * length. The least cost to a destination therefore never overestimates a
+ * search and is a consistent estimate for A*, which is far tighter than the
+ * distance as the crow flies on networks that wind across the map.
+ *
+ * The graph is built from a snapshot of the layout on a background thread,
+ * started and joined at the start of a day. It is only used while the layout
+ * is still the one of the snapshot, so all clients agree on it.
+ */
+class YapfRailJunctionGraph {
+public:
+	static constexpr uint32_t UNREACHABLE = UINT32_MAX; ///< Cost of junctions from which the destination can't be reached.
+
+	/** Destination of a search: a station or waypoint, or some trackdirs of a tile. */
+	struct Destination {
+		StationID station;      ///< Destination station or waypoint, or INVALID_STATION.
+		TileIndex tile;         ///< Destination tile, when not heading for a station.
+		TrackdirBits trackdirs; ///< Trackdirs of the destination tile.
+
+		inline bool operator==(const Destination &other) const
+		{
+			return this->station == other.station && this->tile == other.tile && this->trackdirs == other.trackdirs;
+		}
+	};
+
+	/** Least cost from every junction to one destination. */
+	using Distances = std::vector<uint32_t>;
+
+	bool usable;      ///< Whether the graph matches the current layout.
+	bool job_running; ///< Whether the next graph is being built.
+	bool changed;     ///< Whether the layout changed since the last snapshot was taken.
+
+	YapfRailJunctionGraph();
+	~YapfRailJunctionGraph();
+
+	void Clear();
+	void NotifyTileChange(TileIndex tile);
+	void OnNewDay();
+	void AfterLoad();
+
+	bool IsAvailable() const;
+	std::shared_ptr<const Distances> GetDistances(const Destination &dest);
+	int GetEstimate(const Distances &distances, TileIndex tile, Trackdir td) const;
+
+private:
+	/** What the graph needs to know of a tile with track. */
+	struct SnapshotTile {
+		TileIndex tile;          ///< The tile.
+		TileIndex other_end;     ///< Other end of a tunnel or bridge, or INVALID_TILE.
+		uint16_t trackdirs;      ///< TrackdirBits of the tile.
+		uint16_t skipped;        ///< Number of tiles between the ends of a tunnel or bridge.
+		DiagDirection direction; ///< Direction of a tunnel, bridge or depot.
+		bool depot;              ///< Whether the tile is a depot.
+		bool junction;           ///< Whether all states of the tile are junctions.
+	};
+
+	/** The contracted graph. */
+	struct Graph {
+		std::vector<TileIndex> tiles;                    ///< Tiles with track, by increasing index.
+		std::vector<uint16_t> trackdirs;                 ///< TrackdirBits of each tile.
+		std::vector<uint32_t> first_state;               ///< Index of the first state of each tile.
+		std::vector<uint32_t> state_junction;            ///< Junction each state leads to.
+		std::vector<uint32_t> state_cost;                ///< Least cost from each state to its junction.
+		std::vector<uint32_t> first_edge;                ///< Index of the first edge into each junction in #edges.
+		std::vector<std::pair<uint32_t, uint32_t>> edges; ///< Junction each edge comes from, and its least cost.
+
+		uint32_t FindState(TileIndex tile, Trackdir td) const;
+	};
+
+	/** Distances to a destination kept for later searches. */
+	struct CacheEntry {
+		Destination dest;                          ///< The destination.
+		std::shared_ptr<const Distances> distances; ///< Least cost from every junction to it.
+		uint64_t last_used;                        ///< Value of #cache_clock when last used.
+	};
+
+	std::vector<uint64_t> rail_tiles;        ///< Bit per tile whether it has track; empty when not known.
+	std::vector<TileIndex> pending;          ///< Tiles changed since #rail_tiles was updated.
+	std::unique_ptr<Graph> graph;            ///< The graph in use.
+	std::unique_ptr<Graph> next;             ///< The graph being built.
+	std::vector<SnapshotTile> snapshot;      ///< Snapshot of the layout the next graph is built from.
+	std::thread thread;                      ///< Thread building the next graph.
+	std::vector<CacheEntry> cache;           ///< Distances to recent destinations.
+	uint64_t cache_clock = 0;                ///< Number of lookups in #cache.
+
+	void UpdateRailTiles();
+	void Start();
+	void Join();
+	void BuildGraph();
+	template <typename F> void ForEachSuccessor(const Graph &g, size_t index, Trackdir td, F func) const;
+	bool AddDestination(Distances &distances, std::vector<uint32_t> &seeds, TileIndex tile, TrackdirBits trackdirs) const;
+};
+
+extern YapfRailJunctionGraph _rail_junction_graph;
+
+void InitializeYapfJunctionGraph();
+void AfterLoadYapfJunctionGraph();
+
+#endif /* YAPF_JUNCTION_GRAPH_H */
@@ -0,0 +1,544 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_landmarks.cpp Distances from landmark tiles, for the landmark (ALT) estimate of YAPF. */
+
+#include "../../stdafx.h"
+#include "../../date_type.h"
+#include "../../debug.h"
+#include "../../landscape.h"
+#include "../../map_func.h"
+#include "../../road_func.h"
+#include "../../road_map.h"
+#include "../../settings_type.h"
+#include "../../thread.h"
+#include "../../track_func.h"
+#include "../../tunnelbridge.h"
+#include "../../tunnelbridge_map.h"
+#include "../../timer/timer.h"
+#include "../../timer/timer_game_calendar.h"
+#include "../../timer/timer_game_tick.h"
+#include "../pathfinder_type.h"
+#include "yapf_landmarks.h"
+#include <queue>
+#include <unordered_set>
+
+#include "../../safeguards.h"
+
+/** Number of ticks between choosing the landmarks and using their distances, so the background thread has time to compute them. */
+static const uint LANDMARK_JOB_TICKS = 4 * DAY_TICKS;
+
+/** Number of changed tiles above which the distances are computed anew instead of updated. */
+static const size_t LANDMARK_MAX_PENDING_TILES = 4096;
+
+YapfLandmarks _rail_landmarks(TRANSPORT_RAIL);
+YapfLandmarks _road_landmarks(TRANSPORT_ROAD);
+
+/** Queue of tiles by distance, nearest first. */
+using LandmarkQueue = std::priority_queue<std::pair<uint32_t, uint32_t>, std::vector<std::pair<uint32_t, uint32_t>>, std::greater<std::pair<uint32_t, uint32_t>>>;
+
+/**
+ * Add the cost of a step to a distance, without reaching #YapfLandmarks::UNREACHABLE.
+ * @param distance The distance.
+ * @param cost The cost of the step.
+ * @return The distance after the step.
+ */
+static inline uint32_t AddLandmarkCost(uint32_t distance, uint32_t cost)
+{
+	return distance >= YapfLandmarks::UNREACHABLE - 1 - cost ? YapfLandmarks::UNREACHABLE - 1 : distance + cost;
+}
+
+/**
+ * Create the distances for one transport type, without any landmarks.
+ * @param type The transport type; TRANSPORT_ROAD covers both roads and tram tracks.
+ */
+YapfLandmarks::YapfLandmarks(TransportType type) : type(type), stats{}
+{
+	this->Clear();
+}
+
+YapfLandmarks::~YapfLandmarks()
+{
+	if (this->thread.joinable()) this->thread.join();
+}
+
+/** Forget the landmarks and all distances. */
+void YapfLandmarks::Clear()
+{
+	if (this->thread.joinable()) this->thread.join();
+
+	std::fill(std::begin(this->landmarks), std::end(this->landmarks), INVALID_TILE);
+	this->available_from = 0;
+	this->slots.clear();
+	this->tiles.clear();
+	this->distances.clear();
+	this->pending.clear();
+	this->job_first_edge = {};
+	this->job_edges = {};
+}
+
+/**
+ * Choose the landmarks for the current layout and start computing their distances.
+ * The distances are used once #LANDMARK_JOB_TICKS have passed.
+ */
+void YapfLandmarks::Choose()
+{
+	this->Clear();
+
+	/* Take the tile with track nearest to each corner of the map; such tiles
+	 * are far apart and at the edge of the network, which gives the tightest estimates. */
+	const uint corner_x[NUM_LANDMARKS] = { 0, Map::MaxX(), 0, Map::MaxX() };
+	const uint corner_y[NUM_LANDMARKS] = { 0, 0, Map::MaxY(), Map::MaxY() };
+	uint best[NUM_LANDMARKS] = { UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX };
+
+	for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+		if (this->GetExits(tile) == 0) continue;
+		for (uint i = 0; i < NUM_LANDMARKS; i++) {
+			uint distance = Delta(TileX(tile), corner_x[i]) + Delta(TileY(tile), corner_y[i]);
+			if (distance < best[i]) {
+				best[i] = distance;
+				this->landmarks[i] = tile;
+			}
+		}
+	}
+
+	if (this->landmarks[0] == INVALID_TILE) return;
+
+	this->available_from = TimerGameTick::counter + LANDMARK_JOB_TICKS;
+	this->Restart();
+}
+
+/**
+ * Compute the distances to the current landmarks anew. A snapshot of the
+ * layout is taken now and searched on a background thread; changes made
+ * meanwhile are applied once the thread is done.
+ */
+void YapfLandmarks::Restart()
+{
+	if (this->thread.joinable()) this->thread.join();
+
+	this->slots.clear();
+	this->tiles.clear();
+	this->distances.clear();
+	this->pending.clear();
+
+	for (TileIndex tile = 0; tile < Map::Size(); tile++) {
+		if (this->GetExits(tile) != 0) this->GetSlot(tile);
+	}
+
+	this->job_first_edge.clear();
+	this->job_first_edge.reserve(this->tiles.size() + 1);
+	this->job_edges.clear();
+	for (TileIndex tile : this->tiles) {
+		this->job_first_edge.push_back((uint32_t)this->job_edges.size());
+		this->ForEachNeighbour(tile, [this](TileIndex neighbour, uint32_t cost) {
+			this->job_edges.emplace_back(this->FindSlot(neighbour), cost);
+		});
+	}
+	this->job_first_edge.push_back((uint32_t)this->job_edges.size());
+
+	if (!StartNewThread(&this->thread, "ottd:landmarks", [this]() { this->RunJob(); })) {
+		/* No threads available, so compute the distances right away. */
+		this->RunJob();
+	}
+}
+
+/** Choose the landmarks when there are none yet or when one of them lost its track. */
+void YapfLandmarks::CheckLandmarks()
+{
+	if (!_settings_game.pf.yapf.landmark_heuristic) return;
+
+	for (TileIndex landmark : this->landmarks) {
+		if (landmark == INVALID_TILE || this->GetExits(landmark) == 0) {
+			this->Choose();
+			return;
+		}
+	}
+}
+
+/**
+ * Queue a change of the layout of a tile, to update the distances before they are next used.
+ * @param tile The changed tile.
+ */
+void YapfLandmarks::NotifyTileChange(TileIndex tile)
+{
+	if (this->landmarks[0] == INVALID_TILE) return;
+
+	this->pending.push_back(tile);
+	if (this->pending.size() > 4 * LANDMARK_MAX_PENDING_TILES) {
+		/* Keep long runs of changes without searches from piling up. */
+		std::sort(this->pending.begin(), this->pending.end());
+		this->pending.erase(std::unique(this->pending.begin(), this->pending.end()), this->pending.end());
+	}
+}
+
+/**
+ * Check whether the distances can be used for a search, and bring them up to date.
+ * @return True when the landmark estimate can be used.
+ */
+bool YapfLandmarks::IsAvailable()
+{
+	if (!_settings_game.pf.yapf.landmark_heuristic || this->landmarks[0] == INVALID_TILE) return false;
+	if (TimerGameTick::counter < this->available_from) return false;
+
+	this->Join();
+	if (this->pending.size() > LANDMARK_MAX_PENDING_TILES) {
+		this->Restart();
+		this->Join();
+	}
+	this->ApplyPending();
+	return true;
+}
+
+/**
+ * Get the range of distances from each landmark to a set of destination tiles.
+ * @param area The area containing the destination tiles.
+ * @return The lowest and highest distance to any tile in the area.
+ */
+YapfLandmarks::Bounds YapfLandmarks::GetBounds(const TileArea &area) const
+{
+	Bounds bounds;
+	bounds.min.fill(UNREACHABLE);
+	bounds.max.fill(0);
+
+	for (TileIndex tile : area) {
+		uint32_t slot = this->FindSlot(tile);
+		if (slot == UINT32_MAX) continue;
+
+		for (uint i = 0; i < NUM_LANDMARKS; i++) {
+			uint32_t distance = this->distances[slot][i];
+			if (distance == UNREACHABLE) continue;
+			bounds.min[i] = std::min(bounds.min[i], distance);
+			bounds.max[i] = std::max(bounds.max[i], distance);
+		}
+	}
+	return bounds;
+}
+
+/**
+ * Get the lower bound of the cost from a tile to the nearest destination tile.
+ * @param bounds The distances of the destination tiles, see #GetBounds.
+ * @param tile The tile to estimate the cost for.
+ * @return The estimated cost.
+ */
+int YapfLandmarks::GetEstimate(const Bounds &bounds, TileIndex tile) const
+{
+	uint32_t slot = this->FindSlot(tile);
+	if (slot == UINT32_MAX) return 0;
+
+	uint32_t estimate = 0;
+	for (uint i = 0; i < NUM_LANDMARKS; i++) {
+		uint32_t distance = this->distances[slot][i];
+		if (distance == UNREACHABLE || bounds.min[i] == UNREACHABLE) continue;
+		if (bounds.min[i] > distance) estimate = std::max(estimate, bounds.min[i] - distance);
+		if (distance > bounds.max[i]) estimate = std::max(estimate, distance - bounds.max[i]);
+	}
+	return (int)std::min<uint32_t>(estimate, INT32_MAX / 2);
+}
+
+/**
+ * Count a search, and every now and then log how many nodes searches with and without landmarks needed.
+ * @param used_landmarks Whether the search used the landmark estimate.
+ * @param nodes Number of nodes the search expanded.
+ */
+void YapfLandmarks::RecordSearch(bool used_landmarks, int nodes)
+{
+	SearchStats &stats = this->stats[used_landmarks ? 1 : 0];
+	stats.searches++;
+	stats.nodes += nodes;
+	if (stats.searches % 1024 != 0) return;
+
+	auto average = [](const SearchStats &stats) { return stats.searches == 0 ? 0.0 : (double)stats.nodes / stats.searches; };
+	Debug(yapf, 1, "{} searches: {:.1f} nodes per search with landmarks ({} searches), {:.1f} without ({} searches)",
+			this->type == TRANSPORT_RAIL ? "Rail" : "Road",
+			average(this->stats[1]), this->stats[1].searches, average(this->stats[0]), this->stats[0].searches);
+}
+
+/**
+ * Compare the distances with those computed from scratch for the current layout.
+ * @return True when the distances are not in use, or when they all match.
+ */
+bool YapfLandmarks::CheckDistances()
+{
+	if (!this->IsAvailable()) return true;
+
+	YapfLandmarks fresh(this->type);
+	std::copy(std::begin(this->landmarks), std::end(this->landmarks), fresh.landmarks);
+	fresh.Restart();
+	fresh.Join();
+
+	for (uint32_t slot = 0; slot < fresh.tiles.size(); slot++) {
+		uint32_t own = this->FindSlot(fresh.tiles[slot]);
+		if (own == UINT32_MAX || this->distances[own] != fresh.distances[slot]) return false;
+	}
+	return true;
+}
+
+/**
+ * Get the sides of a tile through which track leaves it. Only the layout
+ * counts, so e.g. roads under road works or red signals still have exits.
+ * @param tile The tile.
+ * @return Bit mask of DiagDirection with the exits.
+ */
+uint8_t YapfLandmarks::GetExits(TileIndex tile) const
+{
+	uint8_t exits = 0;
+
+	if (this->type == TRANSPORT_ROAD) {
+		if (!MayHaveRoad(tile)) return 0;
+		RoadBits bits = GetAnyRoadBits(tile, RTT_ROAD, true) | GetAnyRoadBits(tile, RTT_TRAM, true);
+		for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+			if ((bits & DiagDirToRoadBits(dir)) != ROAD_NONE) SetBit(exits, dir);
+		}
+		return exits;
+	}
+
+	switch (GetTileType(tile)) {
+		case MP_RAILWAY:
+		case MP_ROAD:
+		case MP_STATION:
+		case MP_TUNNELBRIDGE:
+			break;
+
+		default:
+			return 0;
+	}
+
+	TrackdirBits trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, 0));
+	while (trackdirs != TRACKDIR_BIT_NONE) {
+		SetBit(exits, TrackdirToExitdir(RemoveFirstTrackdir(&trackdirs)));
+	}
+	return exits;
+}
+
+/**
+ * Call a function for each tile connected to a tile, in both directions of travel.
+ * Bridge and tunnel heads are connected to their other end, and not to the tile in
+ * the direction of the bridge or tunnel.
+ * @param tile The tile.
+ * @param func Function to call with the connected tile and the cost of the step to it.
+ */
+template <typename F>
+void YapfLandmarks::ForEachNeighbour(TileIndex tile, F func) const
+{
+	const uint8_t exits = this->GetExits(tile);
+	if (exits == 0) return;
+
+	DiagDirection wormhole = INVALID_DIAGDIR;
+	if (IsTileType(tile, MP_TUNNELBRIDGE) && GetTunnelBridgeTransportType(tile) == this->type) {
+		wormhole = GetTunnelBridgeDirection(tile);
+		TileIndex other_end = GetOtherTunnelBridgeEnd(tile);
+		func(other_end, (GetTunnelBridgeLength(tile, other_end) + 1) * YAPF_TILE_CORNER_LENGTH);
+	}
+
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+		if (dir == wormhole) continue;
+
+		TileIndex neighbour = AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(dir));
+		if (neighbour == INVALID_TILE) continue;
+
+		const uint8_t neighbour_exits = this->GetExits(neighbour);
+		if (neighbour_exits == 0) continue;
+
+		/* Bridge and tunnel heads can't be entered from their wormhole side. */
+		DiagDirection back = ReverseDiagDir(dir);
+		if (IsTileType(neighbour, MP_TUNNELBRIDGE) && GetTunnelBridgeTransportType(neighbour) == this->type && GetTunnelBridgeDirection(neighbour) == back) continue;
+
+		if (HasBit(exits, dir) || HasBit(neighbour_exits, back)) func(neighbour, YAPF_TILE_CORNER_LENGTH);
+	}
+}
+
+/**
+ * Find the slot of a tile.
+ * @param tile The tile.
+ * @return The index into #tiles and #distances, or UINT32_MAX when the tile has none.
+ */
+uint32_t YapfLandmarks::FindSlot(TileIndex tile) const
+{
+	auto it = this->slots.find(tile);
+	return it == this->slots.end() ? UINT32_MAX : it->second;
+}
+
+/**
+ * Get the slot of a tile, adding one that isn't connected to any landmark when there is none yet.
+ * @param tile The tile.
+ * @return The index into #tiles and #distances.
+ */
+uint32_t YapfLandmarks::GetSlot(TileIndex tile)
+{
+	auto [it, inserted] = this->slots.try_emplace(tile, (uint32_t)this->tiles.size());
+	if (inserted) {
+		this->tiles.push_back(tile);
+		this->distances.emplace_back().fill(UNREACHABLE);
+	}
+	return it->second;
+}
+
+/** Compute the distances to all landmarks over the snapshot of the layout. Runs on the background thread. */
+void YapfLandmarks::RunJob()
+{
+	for (uint i = 0; i < NUM_LANDMARKS; i++) {
+		uint32_t source = this->FindSlot(this->landmarks[i]);
+		if (source == UINT32_MAX) continue;
+
+		LandmarkQueue queue;
+		this->distances[source][i] = 0;
+		queue.emplace(0, source);
+
+		while (!queue.empty()) {
+			auto [distance, slot] = queue.top();
+			queue.pop();
+			if (distance != this->distances[slot][i]) continue;
+
+			for (uint32_t edge = this->job_first_edge[slot]; edge < this->job_first_edge[slot + 1]; edge++) {
+				auto [neighbour, cost] = this->job_edges[edge];
+				uint32_t neighbour_distance = AddLandmarkCost(distance, cost);
+				if (neighbour_distance < this->distances[neighbour][i]) {
+					this->distances[neighbour][i] = neighbour_distance;
+					queue.emplace(neighbour_distance, neighbour);
+				}
+			}
+		}
+	}
+}
+
+/** Wait for the background thread, if any, and drop its snapshot of the layout. */
+void YapfLandmarks::Join()
+{
+	if (!this->thread.joinable()) return;
+
+	this->thread.join();
+	this->job_first_edge = {};
+	this->job_edges = {};
+}
+
+/** Update the distances for the queued changes of the layout. */
+void YapfLandmarks::ApplyPending()
+{
+	if (this->pending.empty()) return;
+
+	/* A change of a tile can change its connections to all its neighbours. */
+	std::vector<TileIndex> candidates;
+	candidates.reserve(this->pending.size() * 5);
+	for (TileIndex tile : this->pending) {
+		candidates.push_back(tile);
+		for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+			TileIndex neighbour = AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(dir));
+			if (neighbour != INVALID_TILE) candidates.push_back(neighbour);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	this->pending.clear();
+
+	for (uint i = 0; i < NUM_LANDMARKS; i++) this->UpdateLandmark(i, candidates);
+}
+
+/**
+ * Update the distances to one landmark after changes to the layout.
+ * First the tiles whose distance is no longer backed by a path are found,
+ * handling tiles in order of their old distance so a tile is only looked at
+ * after all tiles it may depend on. Then these tiles and the changed tiles
+ * get the best distance their neighbours offer, which is spread from there.
+ * @param landmark Index of the landmark.
+ * @param candidates The changed tiles and their neighbours.
+ */
+void YapfLandmarks::UpdateLandmark(uint landmark, const std::vector<TileIndex> &candidates)
+{
+	const TileIndex source = this->landmarks[landmark];
+	std::unordered_set<uint32_t> invalid;
+	LandmarkQueue queue;
+
+	for (TileIndex tile : candidates) {
+		uint32_t slot = this->FindSlot(tile);
+		if (slot != UINT32_MAX && this->distances[slot][landmark] != UNREACHABLE) queue.emplace(this->distances[slot][landmark], slot);
+	}
+
+	while (!queue.empty()) {
+		auto [distance, slot] = queue.top();
+		queue.pop();
+		if (invalid.count(slot) != 0 || this->tiles[slot] == source) continue;
+
+		bool supported = false;
+		this->ForEachNeighbour(this->tiles[slot], [&](TileIndex neighbour, uint32_t cost) {
+			uint32_t neighbour_slot = this->FindSlot(neighbour);
+			if (supported || neighbour_slot == UINT32_MAX || invalid.count(neighbour_slot) != 0) return;
+			uint32_t neighbour_distance = this->distances[neighbour_slot][landmark];
+			if (neighbour_distance != UNREACHABLE && AddLandmarkCost(neighbour_distance, cost) == distance) supported = true;
+		});
+		if (supported) continue;
+
+		invalid.insert(slot);
+		this->ForEachNeighbour(this->tiles[slot], [&](TileIndex neighbour, uint32_t cost) {
+			uint32_t neighbour_slot = this->FindSlot(neighbour);
+			if (neighbour_slot == UINT32_MAX) return;
+			uint32_t neighbour_distance = this->distances[neighbour_slot][landmark];
+			if (neighbour_distance != UNREACHABLE && neighbour_distance == AddLandmarkCost(distance, cost)) queue.emplace(neighbour_distance, neighbour_slot);
+		});
+	}
+
+	for (uint32_t slot : invalid) this->distances[slot][landmark] = UNREACHABLE;
+
+	auto seed = [&](uint32_t slot) {
+		uint32_t best = this->tiles[slot] == source ? 0 : UNREACHABLE;
+		this->ForEachNeighbour(this->tiles[slot], [&](TileIndex neighbour, uint32_t cost) {
+			uint32_t neighbour_slot = this->FindSlot(neighbour);
+			if (neighbour_slot == UINT32_MAX || this->distances[neighbour_slot][landmark] == UNREACHABLE) return;
+			best = std::min(best, AddLandmarkCost(this->distances[neighbour_slot][landmark], cost));
+		});
+		if (best < this->distances[slot][landmark]) {
+			this->distances[slot][landmark] = best;
+			queue.emplace(best, slot);
+		}
+	};
+	for (TileIndex tile : candidates) {
+		if (this->GetExits(tile) != 0) seed(this->GetSlot(tile));
+	}
+	for (uint32_t slot : invalid) seed(slot);
+
+	while (!queue.empty()) {
+		auto [distance, slot] = queue.top();
+		queue.pop();
+		if (distance != this->distances[slot][landmark]) continue;
+
+		this->ForEachNeighbour(this->tiles[slot], [&](TileIndex neighbour, uint32_t cost) {
+			uint32_t neighbour_slot = this->FindSlot(neighbour);
+			if (neighbour_slot == UINT32_MAX) return;
+			uint32_t neighbour_distance = AddLandmarkCost(distance, cost);
+			if (neighbour_distance < this->distances[neighbour_slot][landmark]) {
+				this->distances[neighbour_slot][landmark] = neighbour_distance;
+				queue.emplace(neighbour_distance, neighbour_slot);
+			}
+		});
+	}
+}
+
+/** Forget all landmarks, e.g. when starting a new game. */
+void InitializeYapfLandmarks()
+{
+	_rail_landmarks.Clear();
+	_road_landmarks.Clear();
+}
+
+/** Compute the distances to the landmarks of a loaded game. */
+void AfterLoadYapfLandmarks()
+{
+	for (YapfLandmarks *landmarks : { &_rail_landmarks, &_road_landmarks }) {
+		if (!_settings_game.pf.yapf.landmark_heuristic) {
+			landmarks->Clear();
+		} else if (landmarks->landmarks[0] != INVALID_TILE) {
+			landmarks->Restart();
+		}
+	}
+}
+
+/** Choose landmarks once a month where they are missing. */
+static IntervalTimer<TimerGameCalendar> _check_yapf_landmarks({TimerGameCalendar::MONTH, TimerGameCalendar::Priority::NONE}, [](auto)
+{
+	_rail_landmarks.CheckLandmarks();
+	_road_landmarks.CheckLandmarks();
+});
@@ -0,0 +1,103 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_landmarks.h Distances from landmark tiles, for the landmark (ALT) estimate of YAPF. */
+
+#ifndef YAPF_LANDMARKS_H
+#define YAPF_LANDMARKS_H
+
+#include "../../tilearea_type.h"
+#include "../../transport_type.h"
+#include <array>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * Distances from a few landmark tiles to every tile with track of one
+ * transport type. The distances are measured over a relaxation of the track
+ * graph: tiles are connected when track leads from one to the other in any
+ * direction, and every step costs #YAPF_TILE_CORNER_LENGTH, the least a tile
+ * can cost in a search. Distances in this graph are never more than the cost
+ * of the same route in a search, so by the triangle inequality the difference
+ * between the distances of two tiles to a landmark is a lower bound for the
+ * cost between them, and a consistent estimate for A*.
+ *
+ * The distances only depend on the landmarks and the current track layout,
+ * so all clients agree on them no matter when they were computed. The first
+ * computation runs on a background thread; afterwards changes to the layout
+ * are applied incrementally.
+ */
+class YapfLandmarks {
+public:
+	static constexpr uint NUM_LANDMARKS = 4;             ///< Number of landmarks, one near each corner of the map.
+	static constexpr uint32_t UNREACHABLE = UINT32_MAX;  ///< Distance of tiles that are not connected to a landmark.
+
+	/** Lowest and highest distance from each landmark to a set of destination tiles. */
+	struct Bounds {
+		std::array<uint32_t, NUM_LANDMARKS> min; ///< Lowest distance to any destination tile, or #UNREACHABLE.
+		std::array<uint32_t, NUM_LANDMARKS> max; ///< Highest distance to any destination tile.
+	};
+
+	/** Number of searches and of nodes they expanded. */
+	struct SearchStats {
+		uint64_t searches; ///< Number of searches.
+		uint64_t nodes;    ///< Number of nodes expanded by these searches.
+	};
+
+	TileIndex landmarks[NUM_LANDMARKS]; ///< The landmark tiles, or INVALID_TILE when none are chosen.
+	uint64_t available_from;            ///< Value of the tick counter from which on the distances are used.
+
+	YapfLandmarks(TransportType type);
+	~YapfLandmarks();
+
+	void Clear();
+	void Choose();
+	void Restart();
+	void CheckLandmarks();
+	void NotifyTileChange(TileIndex tile);
+
+	bool IsAvailable();
+	Bounds GetBounds(const TileArea &area) const;
+	int GetEstimate(const Bounds &bounds, TileIndex tile) const;
+
+	void RecordSearch(bool used_landmarks, int nodes);
+	bool CheckDistances();
+
+private:
+	/** Distances of a tile to each landmark. */
+	using Distances = std::array<uint32_t, NUM_LANDMARKS>;
+
+	TransportType type;                               ///< Transport type of the track.
+	std::unordered_map<uint32_t, uint32_t> slots;     ///< Index into #tiles and #distances for every tile with track.
+	std::vector<TileIndex> tiles;                     ///< The tiles with track.
+	std::vector<Distances> distances;                 ///< Distances of the tiles to the landmarks.
+	std::vector<TileIndex> pending;                   ///< Tiles changed since the distances were last updated.
+
+	std::thread thread;                               ///< Thread computing the distances of a snapshot of the layout.
+	std::vector<uint32_t> job_first_edge;             ///< Snapshot: index of the first edge of every tile in #job_edges.
+	std::vector<std::pair<uint32_t, uint32_t>> job_edges; ///< Snapshot: neighbouring tile and cost of every edge.
+
+	SearchStats stats[2];                             ///< Statistics of searches without and with landmarks.
+
+	uint8_t GetExits(TileIndex tile) const;
+	template <typename F> void ForEachNeighbour(TileIndex tile, F func) const;
+	uint32_t FindSlot(TileIndex tile) const;
+	uint32_t GetSlot(TileIndex tile);
+
+	void RunJob();
+	void Join();
+	void ApplyPending();
+	void UpdateLandmark(uint landmark, const std::vector<TileIndex> &candidates);
+};
+
+extern YapfLandmarks _rail_landmarks;
+extern YapfLandmarks _road_landmarks;
+
+void InitializeYapfLandmarks();
+void AfterLoadYapfLandmarks();
+
+#endif /* YAPF_LANDMARKS_H */
@@ -13,7 +13,10 @@
 #include "yapf_cache.h"
 #include "yapf_node_rail.hpp"
 #include "yapf_costrail.hpp"
+#include "yapf_junction_graph.h"
+#include "yapf_landmarks.h"
 #include "yapf_destrail.hpp"
+#include "../track_status_cache.h"
 #include "../../viewport_func.h"
 #include "../../newgrf_station.h"
 
@@ -122,6 +125,13 @@ private:
 		return (tile != m_res_dest || td != m_res_dest_td) && (tile != m_res_fail_tile || td != m_res_fail_td);
 	}
 
+	/** Drop the cached segments on a reserved tile. Stops at the reservation target. */
+	bool InvalidateReservedTrack(TileIndex tile, Trackdir td)
+	{
+		CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, TrackdirToTrack(td));
+		return tile != m_res_dest || td != m_res_dest_td;
+	}
+
 public:
 	/** Set the target to where the reservation should be extended. */
 	inline void SetReservationTarget(Node *node, TileIndex tile, Trackdir td)
@@ -178,7 +188,9 @@ public:
 		if (target != nullptr) target->okay = true;
 
 		if (Yapf().CanUseGlobalCache(*m_res_node)) {
-			YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+			for (Node *node = m_res_node; node->m_parent != nullptr; node = node->m_parent) {
+				node->IterateTiles(Yapf().GetVehicle(), Yapf(), *this, &CYapfReserveTrack<Types>::InvalidateReservedTrack);
+			}
 		}
 
 		return true;
@@ -429,6 +441,7 @@ public:
 
 		/* find the best path */
 		path_found = Yapf().FindPath(v);
+		_rail_landmarks.RecordSearch(Yapf().UsesLandmarks(), Yapf().GetClosedCount());
 
 		/* if path not found - return INVALID_TRACKDIR */
 		Trackdir next_trackdir = INVALID_TRACKDIR;
@@ -638,10 +651,21 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 	return pfnFindNearestSafeTile(v, tile, td, override_railtype);
 }
 
-/** if any track changes, this counter is incremented - that will invalidate segment cost cache */
-int CSegmentCostCacheBase::s_rail_change_counter = 0;
-
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
 {
 	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+	InvalidateTrackStatusCache(tile);
+	if (tile != INVALID_TILE) {
+		_rail_landmarks.NotifyTileChange(tile);
+		_rail_junction_graph.NotifyTileChange(tile);
+	}
+}
+
+/**
+ * Get the statistics of the caches of rail segment costs.
+ * @return The statistics.
+ */
+YapfSegmentCacheStats YapfGetSegmentCacheStats()
+{
+	return CSegmentCostCacheBase::GetTotalStats();
 }
@@ -10,7 +10,12 @@
 #include "../../stdafx.h"
 #include "yapf.hpp"
 #include "yapf_node_road.hpp"
+#include "yapf_cache.h"
+#include "yapf_road_route_cache.h"
+#include "yapf_landmarks.h"
+#include "../track_status_cache.h"
 #include "../../roadstop_base.h"
+#include "../../timer/timer_game_tick.h"
 
 #include "../../safeguards.h"
 
@@ -234,6 +239,8 @@ protected:
 	StationID    m_dest_station;
 	bool         m_bus;
 	bool         m_non_artic;
+	bool         m_use_landmarks = false;       ///< Whether the landmark estimate is used.
+	YapfLandmarks::Bounds m_landmark_bounds;   ///< Distances from the landmarks to the destination.
 
 public:
 	void SetDestination(const RoadVehicle *v)
@@ -249,6 +256,18 @@ public:
 			m_destTile      = v->dest_tile;
 			m_destTrackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(v->dest_tile, TRANSPORT_ROAD, GetRoadTramType(v->roadtype)));
 		}
+
+		m_use_landmarks = _road_landmarks.IsAvailable();
+		if (m_use_landmarks) {
+			const Station *st = GetDestinationStation();
+			m_landmark_bounds = _road_landmarks.GetBounds(st != nullptr ? (m_bus ? st->bus_station : st->truck_station) : TileArea(m_destTile, 1, 1));
+		}
+	}
+
+	/** Whether the search uses the landmark estimate. */
+	inline bool UsesLandmarks() const
+	{
+		return m_use_landmarks;
 	}
 
 	const Station *GetDestinationStation() const
@@ -306,6 +325,12 @@ public:
 		int dmin = std::min(dx, dy);
 		int dxy = abs(dx - dy);
 		int d = dmin * YAPF_TILE_CORNER_LENGTH + (dxy - 1) * (YAPF_TILE_LENGTH / 2);
+		if (m_use_landmarks) {
+			d = std::max(d, _road_landmarks.GetEstimate(m_landmark_bounds, tile));
+			/* The estimate never decreases along a path; keep it so even if the distances were out of date. */
+			n.m_estimate = std::max(n.m_cost + d, n.m_parent->m_estimate);
+			return true;
+		}
 		n.m_estimate = n.m_cost + d;
 		assert(n.m_estimate >= n.m_parent->m_estimate);
 		return true;
@@ -380,6 +405,7 @@ public:
 
 		/* find the best path */
 		path_found = Yapf().FindPath(v);
+		_road_landmarks.RecordSearch(Yapf().UsesLandmarks(), Yapf().GetClosedCount());
 
 		/* if path not found - return INVALID_TRACKDIR */
 		Trackdir next_trackdir = INVALID_TRACKDIR;
@@ -529,8 +555,128 @@ struct CYapfRoadAnyDepot1 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot1, CRoadNod
 struct CYapfRoadAnyDepot2 : CYapfT<CYapfRoad_TypesT<CYapfRoadAnyDepot2, CRoadNodeListExitDir , CYapfDestinationAnyDepotRoadT> > {};
 
 
+RoadRouteCache _road_route_cache;
+static YapfRoadRouteCacheStats _road_route_cache_stats = {};
+
+/** Drop all shared road vehicle routes, e.g. when starting a new game. */
+void InitializeRoadRouteCache()
+{
+	_road_route_cache.clear();
+}
+
+void YapfNotifyRoadLayoutChange(TileIndex tile)
+{
+	InvalidateTrackStatusCache(tile);
+
+	if (tile == INVALID_TILE) {
+		_road_route_cache.clear();
+		return;
+	}
+
+	_road_landmarks.NotifyTileChange(tile);
+
+	for (auto it = _road_route_cache.begin(); it != _road_route_cache.end();) {
+		if (it->second.area.Contains(tile)) {
+			it = _road_route_cache.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+YapfRoadRouteCacheStats YapfGetRoadRouteCacheStats()
+{
+	return _road_route_cache_stats;
+}
+
+/**
+ * Get the key under which the route of a road vehicle is shared with other vehicles.
+ * @param v The vehicle.
+ * @param tile Tile the vehicle is about to enter.
+ * @param enterdir Direction in which the vehicle enters the tile.
+ * @return The key of the route.
+ */
+static RoadRouteCacheKey GetRoadRouteCacheKey(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir)
+{
+	RoadRouteCacheKey key;
+	key.tile = tile;
+	if (v->current_order.IsType(OT_GOTO_STATION)) {
+		key.dest_tile = INVALID_TILE;
+		key.dest_station = v->current_order.GetDestination();
+	} else {
+		key.dest_tile = v->dest_tile;
+		key.dest_station = INVALID_STATION;
+	}
+	key.compatible_roadtypes = v->compatible_roadtypes;
+	key.roadtype = v->roadtype;
+	key.owner = v->owner;
+	key.enterdir = enterdir;
+	key.max_speed = std::min<int>(v->GetDisplayMaxSpeed(), v->current_order.GetMaxSpeed() * 2);
+	key.bus = v->IsBus();
+	key.articulated = v->HasArticulatedPart();
+	return key;
+}
+
+/**
+ * Share the route found for a road vehicle with other vehicles.
+ * @param key Key of the route.
+ * @param v The vehicle the route was found for.
+ * @param trackdir Trackdir to take on the tile the vehicle is about to enter.
+ * @param path_found Whether the route reaches the destination.
+ * @param path_cache Choices to make further along the route.
+ */
+static void StoreRoadRoute(const RoadRouteCacheKey &key, const RoadVehicle *v, Trackdir trackdir, bool path_found, const RoadVehPathCache &path_cache)
+{
+	if (_road_route_cache.size() >= YAPF_ROADVEH_ROUTE_CACHE_SIZE) {
+		/* Make room by dropping the expired routes, or else the route that expires first. */
+		auto first_to_expire = _road_route_cache.begin();
+		for (auto it = _road_route_cache.begin(); it != _road_route_cache.end();) {
+			if (it->second.expire <= TimerGameTick::counter) {
+				it = _road_route_cache.erase(it);
+				continue;
+			}
+			if (it->second.expire < first_to_expire->second.expire) first_to_expire = it;
+			++it;
+		}
+		if (_road_route_cache.size() >= YAPF_ROADVEH_ROUTE_CACHE_SIZE) _road_route_cache.erase(first_to_expire);
+	}
+
+	RoadRouteCacheEntry &entry = _road_route_cache[key];
+	entry.trackdir = trackdir;
+	entry.path_found = path_found;
+	entry.path = path_cache;
+	entry.expire = TimerGameTick::counter + YAPF_ROADVEH_ROUTE_CACHE_LIFETIME;
+
+	/* The search looked at the roads between the vehicle and its destination,
+	 * so any change of the road layout around those may give another route. */
+	entry.area = TileArea(key.tile);
+	if (IsValidTile(v->dest_tile)) entry.area.Add(v->dest_tile);
+	for (TileIndex t : path_cache.tile) entry.area.Add(t);
+	entry.area.Expand(YAPF_ROADVEH_ROUTE_CACHE_AREA_MARGIN);
+}
+
 Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDirection enterdir, TrackdirBits trackdirs, bool &path_found, RoadVehPathCache &path_cache)
 {
+	/* Take the route another vehicle with the same destination found here, unless it is outdated.
+	 * The pathfinder treats the destination tile itself specially, so do not share those routes. */
+	const bool share_route = tile != v->dest_tile;
+	RoadRouteCacheKey key;
+	if (share_route) {
+		key = GetRoadRouteCacheKey(v, tile, enterdir);
+		auto it = _road_route_cache.find(key);
+		if (it != _road_route_cache.end()) {
+			const RoadRouteCacheEntry &entry = it->second;
+			if (entry.expire > TimerGameTick::counter && HasTrackdir(trackdirs, entry.trackdir)) {
+				_road_route_cache_stats.hits++;
+				path_found = entry.path_found;
+				path_cache = entry.path;
+				return entry.trackdir;
+			}
+			_road_route_cache.erase(it);
+		}
+		_road_route_cache_stats.misses++;
+	}
+
 	/* default is YAPF type 2 */
 	typedef Trackdir (*PfnChooseRoadTrack)(const RoadVehicle*, TileIndex, DiagDirection, bool &path_found, RoadVehPathCache &path_cache);
 	PfnChooseRoadTrack pfnChooseRoadTrack = &CYapfRoad2::stChooseRoadTrack; // default: ExitDir, allow 90-deg
@@ -541,6 +687,7 @@ Trackdir YapfRoadVehicleChooseTrack(const RoadVehicle *v, TileIndex tile, DiagDi
 	}
 
 	Trackdir td_ret = pfnChooseRoadTrack(v, tile, enterdir, path_found, path_cache);
+	if (share_route && td_ret != INVALID_TRACKDIR) StoreRoadRoute(key, v, td_ret, path_found, path_cache);
 	return (td_ret != INVALID_TRACKDIR) ? td_ret : (Trackdir)FindFirstBit2x64(trackdirs);
 }
 
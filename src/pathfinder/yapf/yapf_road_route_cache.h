@@ -0,0 +1,63 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_road_route_cache.h Routes of road vehicles shared by all vehicles heading for the same destination. */
+
+#ifndef YAPF_ROAD_ROUTE_CACHE_H
+#define YAPF_ROAD_ROUTE_CACHE_H
+
+#include "../../date_type.h"
+#include "../../roadveh.h"
+#include "../../tilearea_type.h"
+
+/** Number of ticks after which a shared route is searched again, so it follows changes in road stop occupancy. */
+static const int YAPF_ROADVEH_ROUTE_CACHE_LIFETIME = 4 * DAY_TICKS;
+
+/** Maximum number of shared routes. */
+static const size_t YAPF_ROADVEH_ROUTE_CACHE_SIZE = 4096;
+
+/** Number of tiles around a shared route in which a change of the road layout drops the route. */
+static const int YAPF_ROADVEH_ROUTE_CACHE_AREA_MARGIN = 4;
+
+/** Everything a route found for a road vehicle depends on, except for the road layout and road stop occupancy. */
+struct RoadRouteCacheKey {
+	TileIndex tile;                 ///< Tile the vehicle is about to enter.
+	TileIndex dest_tile;            ///< Destination tile, or INVALID_TILE when heading for a station.
+	StationID dest_station;         ///< Destination station, or INVALID_STATION.
+	RoadTypes compatible_roadtypes; ///< Road types the vehicle is powered on.
+	RoadType roadtype;              ///< Road type of the vehicle.
+	Owner owner;                    ///< Owner of the vehicle.
+	DiagDirection enterdir;         ///< Direction in which the vehicle enters the tile.
+	uint16_t max_speed;             ///< Maximum speed of the vehicle, limited by its current order.
+	bool bus;                       ///< Whether the vehicle is a bus.
+	bool articulated;               ///< Whether the vehicle is articulated.
+
+	inline bool operator<(const RoadRouteCacheKey &other) const
+	{
+		return std::tie(this->tile, this->dest_tile, this->dest_station, this->compatible_roadtypes, this->roadtype, this->owner, this->enterdir, this->max_speed, this->bus, this->articulated) <
+				std::tie(other.tile, other.dest_tile, other.dest_station, other.compatible_roadtypes, other.roadtype, other.owner, other.enterdir, other.max_speed, other.bus, other.articulated);
+	}
+};
+
+/** A route found for a road vehicle, which other vehicles with the same key may take as well. */
+struct RoadRouteCacheEntry {
+	Trackdir trackdir;     ///< Trackdir to take on the tile the vehicle is about to enter.
+	bool path_found;       ///< Whether the route reaches the destination.
+	RoadVehPathCache path; ///< Choices to make further along the route.
+	TileArea area;         ///< Area in which a change of the road layout drops the route.
+	uint64_t expire;       ///< Value of the tick counter at which the route expires.
+};
+
+/**
+ * The shared routes. This is part of the game state: whether a vehicle finds
+ * a shared route decides which way it goes, so the routes are saved.
+ */
+using RoadRouteCache = std::map<RoadRouteCacheKey, RoadRouteCacheEntry>;
+
+extern RoadRouteCache _road_route_cache;
+
+#endif /* YAPF_ROAD_ROUTE_CACHE_H */
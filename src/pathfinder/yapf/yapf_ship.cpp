@@ -11,9 +11,14 @@
 #include "../../ship.h"
 #include "../../industry.h"
 #include "../../vehicle_func.h"
+#include "../../station_base.h"
 
 #include "yapf.hpp"
 #include "yapf_node_ship.hpp"
+#include "yapf_ship_regions.h"
+#include "yapf_cache.h"
+#include "yapf_ship_route_cache.h"
+#include "../../timer/timer_game_tick.h"
 
 #include "../../safeguards.h"
 
@@ -31,6 +36,9 @@ protected:
 	TrackdirBits m_destTrackdirs;
 	StationID    m_destStation;
 
+	std::vector<WaterRegionPatchDesc> m_corridor; ///< Water region patches the search may enter, empty when not restricted.
+	bool m_corridor_is_destination = false;       ///< Whether reaching the last patch of the corridor ends the search.
+
 public:
 	void SetDestination(const Ship *v)
 	{
@@ -45,6 +53,32 @@ public:
 		}
 	}
 
+	/**
+	 * Only search the tiles of the first part of a route over water regions.
+	 * @param path Water region patches from the origin to the destination.
+	 */
+	void RestrictToCorridor(const std::vector<WaterRegionPatchDesc> &path)
+	{
+		const size_t length = std::min<size_t>(path.size(), NUMBER_OF_WATER_REGIONS_LOOKAHEAD + 1);
+		m_corridor.assign(path.begin(), path.begin() + length);
+		if (length < path.size()) {
+			/* The destination is further away; head for the end of the corridor instead. */
+			m_corridor_is_destination = true;
+			m_destTile = GetWaterRegionCenterTile(m_corridor.back());
+		}
+	}
+
+	/**
+	 * Check whether the search may enter a tile.
+	 * @param tile The tile.
+	 * @return True iff there is no corridor or the tile is part of it.
+	 */
+	inline bool IsInCorridor(TileIndex tile) const
+	{
+		if (m_corridor.empty()) return true;
+		return IsInWaterRegionPatches(tile, m_corridor.begin(), m_corridor.end());
+	}
+
 protected:
 	/** to access inherited path finder */
 	inline Tpf& Yapf()
@@ -52,6 +86,24 @@ protected:
 		return *static_cast<Tpf*>(this);
 	}
 
+	/**
+	 * Check whether a tile is part of one of the given water region patches.
+	 * @param tile The tile.
+	 * @param begin First water region patch to check.
+	 * @param end End of the water region patches to check.
+	 * @return True iff the tile is part of one of the patches.
+	 */
+	static bool IsInWaterRegionPatches(TileIndex tile, std::vector<WaterRegionPatchDesc>::const_iterator begin, std::vector<WaterRegionPatchDesc>::const_iterator end)
+	{
+		const int region_x = TileX(tile) / WATER_REGION_EDGE_LENGTH;
+		const int region_y = TileY(tile) / WATER_REGION_EDGE_LENGTH;
+		for (auto it = begin; it != end; ++it) {
+			/* Only look up the patch of the tile when its region is part of the corridor. */
+			if (it->x == region_x && it->y == region_y && GetWaterRegionPatchInfo(tile).label == it->label) return true;
+		}
+		return false;
+	}
+
 public:
 	/** Called by YAPF to detect if node ends in the desired destination */
 	inline bool PfDetectDestination(Node& n)
@@ -61,6 +113,8 @@ public:
 
 	inline bool PfDetectDestinationTile(TileIndex tile, Trackdir trackdir)
 	{
+		if (m_corridor_is_destination) return IsInWaterRegionPatches(tile, m_corridor.end() - 1, m_corridor.end());
+
 		if (m_destStation != INVALID_STATION) {
 			return IsDockingTile(tile) && IsShipDestinationTile(tile, m_destStation);
 		}
@@ -125,7 +179,7 @@ public:
 	inline void PfFollowNode(Node &old_node)
 	{
 		TrackFollower F(Yapf().GetVehicle());
-		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td)) {
+		if (F.Follow(old_node.m_key.m_tile, old_node.m_key.m_td) && Yapf().IsInCorridor(F.m_new_tile)) {
 			Yapf().AddMultipleNodes(&old_node, F);
 		}
 	}
@@ -136,7 +190,7 @@ public:
 		return 'w';
 	}
 
-	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache)
+	static Trackdir ChooseShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache, TileArea *route_area)
 	{
 		/* handle special case - when next tile is destination tile */
 		if (tile == v->dest_tile) {
@@ -150,6 +204,61 @@ public:
 			return (HasTrackdir(trackdirs, veh_dir)) ? veh_dir : (Trackdir)FindFirstBit2x64(trackdirs);
 		}
 
+		/* Plan the route over water regions first, then only the part of it
+		 * close to the ship has to be searched tile by tile. This keeps the
+		 * search small on large seas, where a search over all tiles would
+		 * run out of nodes before reaching the destination. */
+		const std::vector<WaterRegionPatchDesc> high_level_path = YapfShipFindWaterRegionPath(tile, GetDestinationWaterRegionPatches(v));
+		if (!high_level_path.empty()) {
+			Trackdir next_trackdir = FindShipTrack(v, tile, enterdir, &high_level_path, path_found, path_cache, route_area);
+			if (path_found) return next_trackdir;
+			/* The regions only tell which patches touch, not whether a ship
+			 * can actually turn towards the next one. Search without them. */
+			path_cache.clear();
+		}
+
+		return FindShipTrack(v, tile, enterdir, nullptr, path_found, path_cache, route_area);
+	}
+
+	/**
+	 * Get the water region patches of the tiles a ship wants to reach.
+	 * @param v The ship.
+	 * @return The water region patches of the destination.
+	 */
+	static std::vector<WaterRegionPatchDesc> GetDestinationWaterRegionPatches(const Ship *v)
+	{
+		std::vector<WaterRegionPatchDesc> destinations;
+		auto add_destination = [&destinations](TileIndex tile) {
+			WaterRegionPatchDesc patch = GetWaterRegionPatchInfo(tile);
+			if (patch.label != INVALID_WATER_REGION_PATCH && std::find(destinations.begin(), destinations.end(), patch) == destinations.end()) {
+				destinations.push_back(patch);
+			}
+		};
+
+		if (v->current_order.IsType(OT_GOTO_STATION)) {
+			const StationID station = v->current_order.GetDestination();
+			for (TileIndex tile : Station::Get(station)->docking_station) {
+				if (IsDockingTile(tile) && IsShipDestinationTile(tile, station)) add_destination(tile);
+			}
+		} else if (v->dest_tile != INVALID_TILE) {
+			add_destination(v->dest_tile);
+		}
+		return destinations;
+	}
+
+	/**
+	 * Search the path at tile level.
+	 * @param v The ship.
+	 * @param tile The tile the ship is about to enter.
+	 * @param enterdir The direction the ship enters the tile.
+	 * @param high_level_path Route over water regions to restrict the search to, nullptr to search everywhere.
+	 * @param[out] path_found Whether the destination (or the end of the restricted part) was reached.
+	 * @param[out] path_cache Cache for the next steps of the path.
+	 * @param[out] route_area When not nullptr, the area spanned by the origin and the tiles of the path.
+	 * @return The trackdir to take on the tile, or INVALID_TRACKDIR.
+	 */
+	static Trackdir FindShipTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, const std::vector<WaterRegionPatchDesc> *high_level_path, bool &path_found, ShipPathCache &path_cache, TileArea *route_area)
+	{
 		/* move back to the old tile/trackdir (where ship is coming from) */
 		TileIndex src_tile = TileAddByDiagDir(tile, ReverseDiagDir(enterdir));
 		Trackdir trackdir = v->GetVehicleTrackdir();
@@ -163,6 +272,7 @@ public:
 		/* set origin and destination nodes */
 		pf.SetOrigin(src_tile, trackdirs);
 		pf.SetDestination(v);
+		if (high_level_path != nullptr) pf.RestrictToCorridor(*high_level_path);
 		/* find best path */
 		path_found = pf.FindPath(v);
 
@@ -175,9 +285,12 @@ public:
 			uint skip = 0;
 			if (path_found) skip = YAPF_SHIP_PATH_CACHE_LENGTH / 2;
 
+			if (route_area != nullptr) *route_area = TileArea(src_tile);
+
 			/* walk through the path back to the origin */
 			Node *pPrevNode = nullptr;
 			while (pNode->m_parent != nullptr) {
+				if (route_area != nullptr) route_area->Add(pNode->GetTile());
 				steps--;
 				/* Skip tiles at end of path near destination. */
 				if (skip > 0) skip--;
@@ -299,7 +412,7 @@ public:
 		if (IsDockingTile(n.GetTile())) {
 			/* Check docking tile for occupancy */
 			uint count = 0;
-			HasVehicleOnPos(n.GetTile(), &count, &CountShipProc);
+			HasVehicleOnPos(n.GetTile(), VEH_SHIP, &count, &CountShipProc);
 			c += count * 3 * YAPF_TILE_LENGTH;
 		}
 
@@ -348,11 +461,183 @@ struct CYapfShip1 : CYapfT<CYapfShip_TypesT<CYapfShip1, CFollowTrackWater    , C
 /* YAPF type 2 - uses TileIndex/DiagDirection as Node key */
 struct CYapfShip2 : CYapfT<CYapfShip_TypesT<CYapfShip2, CFollowTrackWater    , CShipNodeListExitDir > > {};
 
+ShipRouteCache _ship_route_cache;
+
+/** Drop all shared ship routes, e.g. when starting a new game. */
+void InitializeShipRouteCache()
+{
+	_ship_route_cache.Clear();
+}
+
+void YapfNotifyWaterLayoutChange(TileIndex tile)
+{
+	_ship_route_cache.NotifyTileChange(tile);
+}
+
+/**
+ * Call a function for the index of every water region that overlaps an area.
+ * @param area The area.
+ * @param func The function to call.
+ */
+template <typename F>
+static void ForEachWaterRegionIndex(const TileArea &area, F func)
+{
+	const uint regions_x = CeilDiv(Map::SizeX(), WATER_REGION_EDGE_LENGTH);
+	const uint x0 = TileX(area.tile) / WATER_REGION_EDGE_LENGTH;
+	const uint y0 = TileY(area.tile) / WATER_REGION_EDGE_LENGTH;
+	const uint x1 = (TileX(area.tile) + area.w - 1) / WATER_REGION_EDGE_LENGTH;
+	const uint y1 = (TileY(area.tile) + area.h - 1) / WATER_REGION_EDGE_LENGTH;
+	for (uint y = y0; y <= y1; y++) {
+		for (uint x = x0; x <= x1; x++) func(x + y * regions_x);
+	}
+}
+
+/**
+ * Add a number to the route counts of all water regions a route overlaps.
+ * @param area Area of the route.
+ * @param delta Number to add.
+ */
+void ShipRouteCache::UpdateRegionRefs(const TileArea &area, int delta)
+{
+	if (area.w == 0 || area.h == 0) return;
+	ForEachWaterRegionIndex(area, [&](uint index) {
+		if (index >= this->region_refs.size()) this->region_refs.resize(index + 1, 0);
+		this->region_refs[index] += delta;
+	});
+}
+
+/**
+ * Drop a shared route.
+ * @param it The route.
+ * @return The route after it.
+ */
+ShipRouteCache::Routes::iterator ShipRouteCache::Erase(Routes::iterator it)
+{
+	this->UpdateRegionRefs(it->second.area, -1);
+	return this->routes.erase(it);
+}
+
+/**
+ * Get the shared route for a key, dropping it when it has expired.
+ * @param key The key.
+ * @return The route, or nullptr if there is none.
+ */
+const ShipRouteCacheEntry *ShipRouteCache::Find(const ShipRouteCacheKey &key)
+{
+	auto it = this->routes.find(key);
+	if (it == this->routes.end()) return nullptr;
+	if (it->second.expire > TimerGameTick::counter) return &it->second;
+	this->Erase(it);
+	return nullptr;
+}
+
+/**
+ * Add a shared route, replacing the route with the same key.
+ * @param key The key.
+ * @param entry The route.
+ */
+void ShipRouteCache::Insert(const ShipRouteCacheKey &key, ShipRouteCacheEntry &&entry)
+{
+	auto it = this->routes.find(key);
+	if (it != this->routes.end()) this->Erase(it);
+	this->UpdateRegionRefs(entry.area, 1);
+	this->routes.emplace(key, std::move(entry));
+}
+
+/**
+ * Share a route with other ships, making room for it when there are too many routes.
+ * @param key The key.
+ * @param entry The route.
+ */
+void ShipRouteCache::Store(const ShipRouteCacheKey &key, ShipRouteCacheEntry &&entry)
+{
+	if (this->routes.size() >= YAPF_SHIP_ROUTE_CACHE_SIZE && this->routes.find(key) == this->routes.end()) {
+		/* Make room by dropping the expired routes, or else the route that expires first. */
+		auto first_to_expire = this->routes.end();
+		for (auto it = this->routes.begin(); it != this->routes.end();) {
+			if (it->second.expire <= TimerGameTick::counter) {
+				it = this->Erase(it);
+				continue;
+			}
+			if (first_to_expire == this->routes.end() || it->second.expire < first_to_expire->second.expire) first_to_expire = it;
+			++it;
+		}
+		if (this->routes.size() >= YAPF_SHIP_ROUTE_CACHE_SIZE) this->Erase(first_to_expire);
+	}
+	this->Insert(key, std::move(entry));
+}
+
+/**
+ * Drop the routes near a tile whose water tracks may have changed.
+ * @param tile The tile.
+ */
+void ShipRouteCache::NotifyTileChange(TileIndex tile)
+{
+	uint index = TileX(tile) / WATER_REGION_EDGE_LENGTH + TileY(tile) / WATER_REGION_EDGE_LENGTH * CeilDiv(Map::SizeX(), WATER_REGION_EDGE_LENGTH);
+	if (index >= this->region_refs.size() || this->region_refs[index] == 0) return;
+
+	for (auto it = this->routes.begin(); it != this->routes.end();) {
+		if (it->second.area.Contains(tile)) {
+			it = this->Erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+/** Drop all shared routes. */
+void ShipRouteCache::Clear()
+{
+	this->routes.clear();
+	this->region_refs.clear();
+}
+
+/**
+ * Get the key under which the route of a ship is shared with other ships.
+ * @param v The ship.
+ * @param tile Tile the ship is about to enter.
+ * @param enterdir Direction in which the ship enters the tile.
+ * @return The key of the route.
+ */
+static ShipRouteCacheKey GetShipRouteCacheKey(const Ship *v, TileIndex tile, DiagDirection enterdir)
+{
+	const ShipVehicleInfo *svi = ShipVehInfo(v->engine_type);
+	ShipRouteCacheKey key;
+	key.tile = tile;
+	if (v->current_order.IsType(OT_GOTO_STATION)) {
+		key.dest_tile = INVALID_TILE;
+		key.dest_station = v->current_order.GetDestination();
+	} else {
+		key.dest_tile = v->dest_tile;
+		key.dest_station = INVALID_STATION;
+	}
+	key.trackdir = v->GetVehicleTrackdir();
+	key.enterdir = enterdir;
+	key.ocean_speed_frac = svi->ocean_speed_frac;
+	key.canal_speed_frac = svi->canal_speed_frac;
+	return key;
+}
+
 /** Ship controller helper - path finder invoker */
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, ShipPathCache &path_cache)
 {
+	/* Take the route another ship with the same destination found here. Ferries
+	 * on the same line would otherwise repeat the same search over and over.
+	 * The pathfinder treats the destination tile itself specially, so do not share those routes. */
+	const bool share_route = tile != v->dest_tile;
+	ShipRouteCacheKey key;
+	if (share_route) {
+		key = GetShipRouteCacheKey(v, tile, enterdir);
+		const ShipRouteCacheEntry *entry = _ship_route_cache.Find(key);
+		if (entry != nullptr && HasTrack(tracks, TrackdirToTrack(entry->trackdir))) {
+			path_found = entry->path_found;
+			path_cache = entry->path;
+			return TrackdirToTrack(entry->trackdir);
+		}
+	}
+
 	/* default is YAPF type 2 */
-	typedef Trackdir (*PfnChooseShipTrack)(const Ship*, TileIndex, DiagDirection, TrackBits, bool &path_found, ShipPathCache &path_cache);
+	typedef Trackdir (*PfnChooseShipTrack)(const Ship*, TileIndex, DiagDirection, TrackBits, bool &path_found, ShipPathCache &path_cache, TileArea *route_area);
 	PfnChooseShipTrack pfnChooseShipTrack = CYapfShip2::ChooseShipTrack; // default: ExitDir
 
 	/* check if non-default YAPF type needed */
@@ -360,7 +645,12 @@ Track YapfShipChooseTrack(const Ship *v, TileIndex tile, DiagDirection enterdir,
 		pfnChooseShipTrack = &CYapfShip1::ChooseShipTrack; // Trackdir
 	}
 
-	Trackdir td_ret = pfnChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache);
+	TileArea route_area;
+	Trackdir td_ret = pfnChooseShipTrack(v, tile, enterdir, tracks, path_found, path_cache, share_route ? &route_area : nullptr);
+	if (share_route && td_ret != INVALID_TRACKDIR) {
+		route_area.Expand(YAPF_SHIP_ROUTE_CACHE_AREA_MARGIN);
+		_ship_route_cache.Store(key, { td_ret, path_found, path_cache, route_area, TimerGameTick::counter + YAPF_SHIP_ROUTE_CACHE_LIFETIME });
+	}
 	return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : INVALID_TRACK;
 }
 
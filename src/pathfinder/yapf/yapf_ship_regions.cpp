@@ -0,0 +1,94 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_ship_regions.cpp Implementation of the ship pathfinder on the level of water regions. */
+
+#include "../../stdafx.h"
+#include "yapf_ship_regions.h"
+
+#include <queue>
+#include <unordered_map>
+
+#include "../../safeguards.h"
+
+/** Maximum number of water region patches the search visits before giving up. */
+static const size_t MAX_WATER_REGION_SEARCH_NODES = 1 << 16;
+
+/** Node of the search over water region patches. */
+struct WaterRegionNode {
+	WaterRegionPatchDesc patch; ///< The water region patch of this node.
+	int cost;                   ///< Number of regions passed from the origin.
+	int parent;                 ///< Index of the node this node was reached from, -1 for the origin.
+};
+
+/**
+ * Estimate the number of regions between a patch and the nearest destination.
+ * @param patch The water region patch.
+ * @param destinations The destination patches.
+ * @return The Manhattan distance in regions to the nearest destination.
+ */
+static int EstimateWaterRegionDistance(const WaterRegionPatchDesc &patch, const std::vector<WaterRegionPatchDesc> &destinations)
+{
+	int distance = INT_MAX;
+	for (const WaterRegionPatchDesc &destination : destinations) {
+		distance = std::min(distance, abs(patch.x - destination.x) + abs(patch.y - destination.y));
+	}
+	return distance;
+}
+
+/**
+ * Find a route over water region patches with A*. As each step between
+ * regions costs the same, this is cheap compared to a search at tile level,
+ * and it can tell quickly when the destination cannot be reached at all.
+ * @param start_tile Tile the route starts at.
+ * @param destinations Water region patches of the destination.
+ * @return The water region patches from the start to a destination, or an empty list when no route was found.
+ */
+std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(TileIndex start_tile, const std::vector<WaterRegionPatchDesc> &destinations)
+{
+	const WaterRegionPatchDesc start = GetWaterRegionPatchInfo(start_tile);
+	if (start.label == INVALID_WATER_REGION_PATCH || destinations.empty()) return {};
+
+	std::vector<WaterRegionNode> nodes;
+	/* Pairs of the estimated total cost and the node index; the index breaks ties so the result does not depend on the implementation of the queue. */
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> open;
+	std::unordered_map<int, int> best_costs;
+
+	nodes.push_back({start, 0, -1});
+	open.emplace(EstimateWaterRegionDistance(start, destinations), 0);
+	best_costs[CalculateWaterRegionPatchHash(start)] = 0;
+
+	while (!open.empty() && nodes.size() < MAX_WATER_REGION_SEARCH_NODES) {
+		const int index = open.top().second;
+		open.pop();
+
+		const WaterRegionNode node = nodes[index];
+		/* A cheaper way to this patch was found after this node was queued. */
+		if (node.cost > best_costs[CalculateWaterRegionPatchHash(node.patch)]) continue;
+
+		if (std::find(destinations.begin(), destinations.end(), node.patch) != destinations.end()) {
+			std::vector<WaterRegionPatchDesc> path;
+			for (int i = index; i != -1; i = nodes[i].parent) path.push_back(nodes[i].patch);
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+
+		TVisitWaterRegionPatchCallBack visit = [&](const WaterRegionPatchDesc &neighbour) {
+			const int cost = node.cost + 1;
+			auto [it, inserted] = best_costs.try_emplace(CalculateWaterRegionPatchHash(neighbour), cost);
+			if (!inserted) {
+				if (it->second <= cost) return;
+				it->second = cost;
+			}
+			nodes.push_back({neighbour, cost, index});
+			open.emplace(cost + EstimateWaterRegionDistance(neighbour, destinations), static_cast<int>(nodes.size() - 1));
+		};
+		VisitWaterRegionPatchNeighbors(node.patch, visit);
+	}
+
+	return {};
+}
@@ -0,0 +1,20 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_ship_regions.h Implementation of the ship pathfinder on the level of water regions. */
+
+#ifndef YAPF_SHIP_REGIONS_H
+#define YAPF_SHIP_REGIONS_H
+
+#include "../water_regions.h"
+
+/** Number of water regions beyond the current one a ship plans its route at tile level. */
+static const int NUMBER_OF_WATER_REGIONS_LOOKAHEAD = 4;
+
+std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(TileIndex start_tile, const std::vector<WaterRegionPatchDesc> &destinations);
+
+#endif /* YAPF_SHIP_REGIONS_H */
@@ -0,0 +1,85 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_ship_route_cache.h Routes of ships shared by all ships heading for the same destination. */
+
+#ifndef YAPF_SHIP_ROUTE_CACHE_H
+#define YAPF_SHIP_ROUTE_CACHE_H
+
+#include "../../date_type.h"
+#include "../../ship.h"
+#include "../../tilearea_type.h"
+
+/** Number of ticks after which a shared route is searched again, so it follows changes in dock occupancy. */
+static const int YAPF_SHIP_ROUTE_CACHE_LIFETIME = 4 * DAY_TICKS;
+
+/** Maximum number of shared routes. */
+static const size_t YAPF_SHIP_ROUTE_CACHE_SIZE = 1024;
+
+/** Number of tiles around a shared route in which a change of the water layout drops the route. */
+static const int YAPF_SHIP_ROUTE_CACHE_AREA_MARGIN = 1;
+
+/** Everything a route found for a ship depends on, except for the water layout and dock occupancy. */
+struct ShipRouteCacheKey {
+	TileIndex tile;           ///< Tile the ship is about to enter.
+	TileIndex dest_tile;      ///< Destination tile, or INVALID_TILE when heading for a station.
+	StationID dest_station;   ///< Destination station, or INVALID_STATION.
+	Trackdir trackdir;        ///< Trackdir of the ship on the tile it comes from.
+	DiagDirection enterdir;   ///< Direction in which the ship enters the tile.
+	uint8_t ocean_speed_frac; ///< Fraction of its speed the ship loses on sea.
+	uint8_t canal_speed_frac; ///< Fraction of its speed the ship loses on canals and rivers.
+
+	inline bool operator<(const ShipRouteCacheKey &other) const
+	{
+		return std::tie(this->tile, this->dest_tile, this->dest_station, this->trackdir, this->enterdir, this->ocean_speed_frac, this->canal_speed_frac) <
+				std::tie(other.tile, other.dest_tile, other.dest_station, other.trackdir, other.enterdir, other.ocean_speed_frac, other.canal_speed_frac);
+	}
+};
+
+/** A route found for a ship, which other ships with the same key may take as well. */
+struct ShipRouteCacheEntry {
+	Trackdir trackdir;  ///< Trackdir to take on the tile the ship is about to enter.
+	bool path_found;    ///< Whether the route reaches the destination.
+	ShipPathCache path; ///< Choices to make further along the route.
+	TileArea area;      ///< Area of the route in which a change of the water layout drops it.
+	uint64_t expire;    ///< Value of the tick counter at which the route expires.
+};
+
+/**
+ * The routes shared by ships. This is part of the game state: whether a ship
+ * finds a shared route decides which way it goes, so the routes are saved.
+ *
+ * Every change of a tile type calls #NotifyTileChange, so the routes keep a
+ * count of routes per water region to skip the changes far from any route.
+ */
+class ShipRouteCache {
+public:
+	using Routes = std::map<ShipRouteCacheKey, ShipRouteCacheEntry>;
+
+	/** The shared routes. */
+	inline const Routes &GetRoutes() const
+	{
+		return this->routes;
+	}
+
+	const ShipRouteCacheEntry *Find(const ShipRouteCacheKey &key);
+	void Store(const ShipRouteCacheKey &key, ShipRouteCacheEntry &&entry);
+	void Insert(const ShipRouteCacheKey &key, ShipRouteCacheEntry &&entry);
+	void NotifyTileChange(TileIndex tile);
+	void Clear();
+
+private:
+	Routes routes;                     ///< The shared routes.
+	std::vector<uint32_t> region_refs; ///< Number of routes overlapping each water region.
+
+	Routes::iterator Erase(Routes::iterator it);
+	void UpdateRegionRefs(const TileArea &area, int delta);
+};
+
+extern ShipRouteCache _ship_route_cache;
+
+#endif /* YAPF_SHIP_ROUTE_CACHE_H */
@@ -60,6 +60,8 @@
 #include "../timer/timer.h"
 #include "../timer/timer_game_calendar.h"
 #include "../timer/timer_game_tick.h"
+#include "../pathfinder/yapf/yapf_junction_graph.h"
+#include "../pathfinder/yapf/yapf_landmarks.h"
 
 #include "saveload_internal.h"
 
@@ -296,6 +298,9 @@ static void InitializeWindowsAndCaches()
 
 	RecomputePrices();
 
+	RebuildLoadingStations();
+	for (Station *st : Station::Iterate()) st->RebuildRatingCargoes();
+
 	GroupStatistics::UpdateAfterLoad();
 
 	RebuildSubsidisedSourceAndDestinationCache();
@@ -2190,6 +2195,14 @@ bool AfterLoadGame()
 		}
 	}
 
+	if (IsSavegameVersionBefore(SLV_ANIMATED_TILE_SPEED)) {
+		/* Animated tiles did not know their animation speed, so visit them every tick until they are animated. */
+		extern std::vector<TileIndex> _animated_tiles;
+		extern std::vector<uint8_t> _animated_tile_speeds;
+
+		_animated_tile_speeds.assign(_animated_tiles.size(), 0);
+	}
+
 	if (IsSavegameVersionBefore(SLV_124) && !IsSavegameVersionBefore(SLV_1)) {
 		/* The train station tile area was added, but for really old (TTDPatch) it's already valid. */
 		for (Waypoint *wp : Waypoint::Iterate()) {
@@ -3254,6 +3267,8 @@ bool AfterLoadGame()
 	ResetSignalHandlers();
 
 	AfterLoadLinkGraphs();
+	AfterLoadYapfLandmarks();
+	AfterLoadYapfJunctionGraph();
 
 	CheckGroundVehiclesAtCorrectZ();
 
@@ -17,9 +17,11 @@
 #include "../safeguards.h"
 
 extern std::vector<TileIndex> _animated_tiles;
+extern std::vector<uint8_t> _animated_tile_speeds;
 
 static const SaveLoad _animated_tile_desc[] = {
 	 SLEG_VECTOR("tiles", _animated_tiles, SLE_UINT32),
+	 SLEG_CONDVECTOR("speeds", _animated_tile_speeds, SLE_UINT8, SLV_ANIMATED_TILE_SPEED, SL_MAX_VERSION),
 };
 
 struct ANITChunkHandler : ChunkHandler {
@@ -61,6 +63,11 @@ struct ANITChunkHandler : ChunkHandler {
 		if (SlIterateArray() == -1) return;
 		SlGlobList(slt);
 		if (SlIterateArray() != -1) SlErrorCorrupt("Too many ANIT entries");
+
+		if (!IsSavegameVersionBefore(SLV_ANIMATED_TILE_SPEED)) {
+			if (_animated_tile_speeds.size() != _animated_tiles.size()) SlErrorCorrupt("Animated tile speeds do not match the animated tiles");
+			if (!std::is_sorted(_animated_tile_speeds.begin(), _animated_tile_speeds.end())) SlErrorCorrupt("Animated tile speeds are not in order");
+		}
 	}
 };
 
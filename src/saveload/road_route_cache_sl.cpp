@@ -0,0 +1,73 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file road_route_cache_sl.cpp Code handling saving and loading of the routes shared by road vehicles. */
+
+#include "../stdafx.h"
+#include "../pathfinder/yapf/yapf_road_route_cache.h"
+
+#include "saveload.h"
+
+#include "../safeguards.h"
+
+static RoadRouteCacheKey _route_key; ///< Key of the route being saved or loaded.
+
+static const SaveLoad _road_route_desc[] = {
+	SLEG_VAR("tile",                 _route_key.tile,                 SLE_UINT32),
+	SLEG_VAR("dest_tile",            _route_key.dest_tile,            SLE_UINT32),
+	SLEG_VAR("dest_station",         _route_key.dest_station,         SLE_UINT16),
+	SLEG_VAR("compatible_roadtypes", _route_key.compatible_roadtypes, SLE_UINT64),
+	SLEG_VAR("roadtype",             _route_key.roadtype,             SLE_UINT8),
+	SLEG_VAR("owner",                _route_key.owner,                SLE_UINT8),
+	SLEG_VAR("enterdir",             _route_key.enterdir,             SLE_UINT8),
+	SLEG_VAR("max_speed",            _route_key.max_speed,            SLE_UINT16),
+	SLEG_VAR("bus",                  _route_key.bus,                  SLE_BOOL),
+	SLEG_VAR("articulated",          _route_key.articulated,          SLE_BOOL),
+	 SLE_VAR(RoadRouteCacheEntry, trackdir,   SLE_UINT8),
+	 SLE_VAR(RoadRouteCacheEntry, path_found, SLE_BOOL),
+	 SLE_CONDDEQUE(RoadRouteCacheEntry, path.td,   SLE_UINT8,  SL_MIN_VERSION, SL_MAX_VERSION),
+	 SLE_CONDDEQUE(RoadRouteCacheEntry, path.tile, SLE_UINT32, SL_MIN_VERSION, SL_MAX_VERSION),
+	 SLE_VAR(RoadRouteCacheEntry, area.tile,  SLE_UINT32),
+	 SLE_VAR(RoadRouteCacheEntry, area.w,     SLE_UINT16),
+	 SLE_VAR(RoadRouteCacheEntry, area.h,     SLE_UINT16),
+	 SLE_VAR(RoadRouteCacheEntry, expire,     SLE_UINT64),
+};
+
+struct RVRCChunkHandler : ChunkHandler {
+	RVRCChunkHandler() : ChunkHandler('RVRC', CH_TABLE) {}
+
+	void Save() const override
+	{
+		SlTableHeader(_road_route_desc);
+
+		int index = 0;
+		for (auto &it : _road_route_cache) {
+			_route_key = it.first;
+			SlSetArrayIndex(index++);
+			SlObject(&it.second, _road_route_desc);
+		}
+	}
+
+	void Load() const override
+	{
+		SlTableHeader(_road_route_desc);
+
+		while (SlIterateArray() != -1) {
+			RoadRouteCacheEntry entry;
+			SlObject(&entry, _road_route_desc);
+			if (entry.path.td.size() != entry.path.tile.size()) SlErrorCorrupt("Invalid shared road vehicle route");
+			_road_route_cache[_route_key] = std::move(entry);
+		}
+	}
+};
+
+static const RVRCChunkHandler RVRC;
+static const ChunkHandlerRef road_route_cache_chunk_handlers[] = {
+	RVRC,
+};
+
+extern const ChunkHandlerTable _road_route_cache_chunk_handlers(road_route_cache_chunk_handlers);
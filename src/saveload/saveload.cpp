@@ -250,6 +250,10 @@ static const std::vector<ChunkHandlerRef> &ChunkHandlers()
 	extern const ChunkHandlerTable _object_chunk_handlers;
 	extern const ChunkHandlerTable _persistent_storage_chunk_handlers;
 	extern const ChunkHandlerTable _plan_chunk_handlers;
+	extern const ChunkHandlerTable _road_route_cache_chunk_handlers;
+	extern const ChunkHandlerTable _ship_route_cache_chunk_handlers;
+	extern const ChunkHandlerTable _yapf_landmarks_chunk_handlers;
+	extern const ChunkHandlerTable _yapf_junction_graph_chunk_handlers;
 
 	/** List of all chunks in a savegame. */
 	static const ChunkHandlerTable _chunk_handler_tables[] = {
@@ -288,6 +292,10 @@ static const std::vector<ChunkHandlerRef> &ChunkHandlers()
 		_object_chunk_handlers,
 		_persistent_storage_chunk_handlers,
 		_plan_chunk_handlers,
+		_road_route_cache_chunk_handlers,
+		_ship_route_cache_chunk_handlers,
+		_yapf_landmarks_chunk_handlers,
+		_yapf_junction_graph_chunk_handlers,
 	};
 
 	static std::vector<ChunkHandlerRef> _chunk_handlers;
@@ -360,6 +360,12 @@ enum SaveLoadVersion : uint16_t {
 	SLV_PERIODS_IN_TRANSIT_RENAME,          ///< 316  PR#11112 Rename days in transit to (cargo) periods in transit.
 	
 	SLV_INFRASTRUCTURE_SHARING,
+	SLV_ANIMATED_TILE_SPEED,                ///< 318  Animated tiles are kept ordered by their animation speed.
+	SLV_CARGO_AGING_EPOCH,                  ///< 319  Cargo in vehicles is aged lazily using an aging epoch.
+	SLV_ROADVEH_ROUTE_CACHE,                ///< 320  Routes of road vehicles are shared between vehicles heading for the same destination.
+	SLV_YAPF_LANDMARKS,                     ///< 321  Landmarks of the landmark estimate of YAPF.
+	SLV_YAPF_JUNCTION_GRAPH,                ///< 322  State of the rail junction graph of YAPF.
+	SLV_SHIP_ROUTE_CACHE,                   ///< 323  Routes of ships are shared between ships heading for the same destination.
 
 	SL_MAX_VERSION,                         ///< Highest possible saveload version
 };
@@ -0,0 +1,68 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file ship_route_cache_sl.cpp Code handling saving and loading of the routes shared by ships. */
+
+#include "../stdafx.h"
+#include "../pathfinder/yapf/yapf_ship_route_cache.h"
+
+#include "saveload.h"
+
+#include "../safeguards.h"
+
+static ShipRouteCacheKey _route_key; ///< Key of the route being saved or loaded.
+
+static const SaveLoad _ship_route_desc[] = {
+	SLEG_VAR("tile",             _route_key.tile,             SLE_UINT32),
+	SLEG_VAR("dest_tile",        _route_key.dest_tile,        SLE_UINT32),
+	SLEG_VAR("dest_station",     _route_key.dest_station,     SLE_UINT16),
+	SLEG_VAR("trackdir",         _route_key.trackdir,         SLE_UINT8),
+	SLEG_VAR("enterdir",         _route_key.enterdir,         SLE_UINT8),
+	SLEG_VAR("ocean_speed_frac", _route_key.ocean_speed_frac, SLE_UINT8),
+	SLEG_VAR("canal_speed_frac", _route_key.canal_speed_frac, SLE_UINT8),
+	 SLE_VAR(ShipRouteCacheEntry, trackdir,   SLE_UINT8),
+	 SLE_VAR(ShipRouteCacheEntry, path_found, SLE_BOOL),
+	 SLE_CONDDEQUE(ShipRouteCacheEntry, path, SLE_UINT8, SL_MIN_VERSION, SL_MAX_VERSION),
+	 SLE_VAR(ShipRouteCacheEntry, area.tile,  SLE_UINT32),
+	 SLE_VAR(ShipRouteCacheEntry, area.w,     SLE_UINT16),
+	 SLE_VAR(ShipRouteCacheEntry, area.h,     SLE_UINT16),
+	 SLE_VAR(ShipRouteCacheEntry, expire,     SLE_UINT64),
+};
+
+struct SHRCChunkHandler : ChunkHandler {
+	SHRCChunkHandler() : ChunkHandler('SHRC', CH_TABLE) {}
+
+	void Save() const override
+	{
+		SlTableHeader(_ship_route_desc);
+
+		int index = 0;
+		for (const auto &it : _ship_route_cache.GetRoutes()) {
+			_route_key = it.first;
+			SlSetArrayIndex(index++);
+			SlObject(const_cast<ShipRouteCacheEntry *>(&it.second), _ship_route_desc);
+		}
+	}
+
+	void Load() const override
+	{
+		SlTableHeader(_ship_route_desc);
+
+		while (SlIterateArray() != -1) {
+			ShipRouteCacheEntry entry;
+			SlObject(&entry, _ship_route_desc);
+			_ship_route_cache.Insert(_route_key, std::move(entry));
+		}
+	}
+};
+
+static const SHRCChunkHandler SHRC;
+static const ChunkHandlerRef ship_route_cache_chunk_handlers[] = {
+	SHRC,
+};
+
+extern const ChunkHandlerTable _ship_route_cache_chunk_handlers(ship_route_cache_chunk_handlers);
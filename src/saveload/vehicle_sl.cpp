@@ -249,6 +249,8 @@ void AfterLoadVehicles(bool part_of_load)
 		if (v->IsGroundVehicle()) v->GetGroundVehicleCache()->first_engine = INVALID_ENGINE;
 	}
 
+	RebuildVehicleTickList();
+
 	/* AfterLoadVehicles may also be called in case of NewGRF reload, in this
 	 * case we may not convert orders again. */
 	if (part_of_load) {
@@ -638,6 +640,7 @@ public:
 		SLE_CONDREFLIST(Vehicle, cargo.packets,     REF_CARGO_PACKET,            SLV_68, SL_MAX_VERSION),
 		SLE_CONDARR(Vehicle, cargo.action_counts,   SLE_UINT, VehicleCargoList::NUM_MOVE_TO_ACTION, SLV_181, SL_MAX_VERSION),
 		SLE_CONDVAR(Vehicle, cargo_age_counter,     SLE_UINT16,                 SLV_162, SL_MAX_VERSION),
+		SLE_CONDVAR(Vehicle, cargo.aging_epoch,     SLE_UINT32,   SLV_CARGO_AGING_EPOCH, SL_MAX_VERSION),
 
 		    SLE_VAR(Vehicle, day_counter,           SLE_UINT8),
 		    SLE_VAR(Vehicle, tick_counter,          SLE_UINT8),
@@ -0,0 +1,50 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_junction_graph_sl.cpp Code handling saving and loading of the state of the rail junction graph of YAPF. */
+
+#include "../stdafx.h"
+#include "../pathfinder/yapf/yapf_junction_graph.h"
+
+#include "saveload.h"
+
+#include "../safeguards.h"
+
+static const SaveLoad _yapf_junction_graph_desc[] = {
+	SLE_VAR(YapfRailJunctionGraph, usable,      SLE_BOOL),
+	SLE_VAR(YapfRailJunctionGraph, job_running, SLE_BOOL),
+	SLE_VAR(YapfRailJunctionGraph, changed,     SLE_BOOL),
+};
+
+/** Whether the junction graph is in use and being rebuilt; the graph itself is rebuilt after loading. */
+struct YJGRChunkHandler : ChunkHandler {
+	YJGRChunkHandler() : ChunkHandler('YJGR', CH_TABLE) {}
+
+	void Save() const override
+	{
+		SlTableHeader(_yapf_junction_graph_desc);
+
+		SlSetArrayIndex(0);
+		SlObject(&_rail_junction_graph, _yapf_junction_graph_desc);
+	}
+
+	void Load() const override
+	{
+		SlTableHeader(_yapf_junction_graph_desc);
+
+		if (SlIterateArray() == -1) return;
+		SlObject(&_rail_junction_graph, _yapf_junction_graph_desc);
+		if (SlIterateArray() != -1) SlErrorCorrupt("Too many YJGR entries");
+	}
+};
+
+static const YJGRChunkHandler YJGR;
+static const ChunkHandlerRef yapf_junction_graph_chunk_handlers[] = {
+	YJGR,
+};
+
+extern const ChunkHandlerTable _yapf_junction_graph_chunk_handlers(yapf_junction_graph_chunk_handlers);
@@ -0,0 +1,55 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_landmarks_sl.cpp Code handling saving and loading of the landmarks of YAPF. */
+
+#include "../stdafx.h"
+#include "../pathfinder/yapf/yapf_landmarks.h"
+
+#include "saveload.h"
+
+#include "../safeguards.h"
+
+static const SaveLoad _yapf_landmarks_desc[] = {
+	SLE_ARR(YapfLandmarks, landmarks,      SLE_UINT32, YapfLandmarks::NUM_LANDMARKS),
+	SLE_VAR(YapfLandmarks, available_from, SLE_UINT64),
+};
+
+/** The landmarks of each transport type, in the order they are saved. */
+static YapfLandmarks * const _saved_landmarks[] = { &_rail_landmarks, &_road_landmarks };
+
+struct YLMKChunkHandler : ChunkHandler {
+	YLMKChunkHandler() : ChunkHandler('YLMK', CH_TABLE) {}
+
+	void Save() const override
+	{
+		SlTableHeader(_yapf_landmarks_desc);
+
+		for (uint i = 0; i < lengthof(_saved_landmarks); i++) {
+			SlSetArrayIndex(i);
+			SlObject(_saved_landmarks[i], _yapf_landmarks_desc);
+		}
+	}
+
+	void Load() const override
+	{
+		SlTableHeader(_yapf_landmarks_desc);
+
+		int index;
+		while ((index = SlIterateArray()) != -1) {
+			if ((uint)index >= lengthof(_saved_landmarks)) SlErrorCorrupt("Too many YAPF landmark tables");
+			SlObject(_saved_landmarks[index], _yapf_landmarks_desc);
+		}
+	}
+};
+
+static const YLMKChunkHandler YLMK;
+static const ChunkHandlerRef yapf_landmarks_chunk_handlers[] = {
+	YLMK,
+};
+
+extern const ChunkHandlerTable _yapf_landmarks_chunk_handlers(yapf_landmarks_chunk_handlers);
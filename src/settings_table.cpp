@@ -17,6 +17,7 @@
 #include "network/network_func.h"
 #include "network/core/config.h"
 #include "pathfinder/pathfinder_type.h"
+#include "pathfinder/track_status_cache.h"
 #include "genworld.h"
 #include "train.h"
 #include "news_func.h"
@@ -46,6 +47,9 @@
 #include "vehicle_func.h"
 #include "viewport_func.h"
 #include "void_map.h"
+#include "pathfinder/yapf/yapf_junction_graph.h"
+#include "pathfinder/yapf/yapf_landmarks.h"
+#include "pathfinder/yapf/yapf_ship_route_cache.h"
 
 #include "table/strings.h"
 #include "table/settings.h"
@@ -465,6 +469,26 @@ static void InvalidateShipPathCache(int32_t new_value)
 	for (Ship *s : Ship::Iterate()) {
 		s->path.clear();
 	}
+	_ship_route_cache.Clear();
+}
+
+/** Forget the landmarks of YAPF; when the landmark estimate is enabled they are chosen anew at the start of the next month. */
+static void InvalidateYapfLandmarks(int32_t)
+{
+	_rail_landmarks.Clear();
+	_road_landmarks.Clear();
+}
+
+/** Forget the rail junction graph of YAPF; when it is enabled it is built anew at the start of the next day. */
+static void InvalidateYapfJunctionGraph(int32_t)
+{
+	_rail_junction_graph.Clear();
+}
+
+/** Allocate or free the track status cache after it was enabled or disabled. */
+static void ResetTrackStatusCache(int32_t)
+{
+	InitializeTrackStatusCache();
 }
 
 /**
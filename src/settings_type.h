@@ -469,6 +469,8 @@ struct YAPFSettings {
 	uint32_t rail_shorter_platform_per_tile_penalty; ///< penalty for shorter station platform than train (per tile)
 	uint32_t ship_curve45_penalty;                   ///< penalty for 45-deg curve for ships
 	uint32_t ship_curve90_penalty;                   ///< penalty for 90-deg curve for ships
+	bool   landmark_heuristic;                     ///< estimate the remaining cost with distances to landmarks
+	bool   rail_junction_graph;                    ///< estimate the remaining cost of trains over the graph of rail junctions
 };
 
 /** Settings related to all pathfinders. */
@@ -488,6 +490,7 @@ struct PathfinderSettings {
 	bool   reserve_paths;                    ///< always reserve paths regardless of signal type.
 	byte   wait_for_pbs_path;                ///< how long to wait for a path reservation.
 	byte   path_backoff_interval;            ///< ticks between checks for a free path.
+	bool   track_status_cache;               ///< keep the trackdirs of every tile in a side table for the track followers
 
 	NPFSettings  npf;                        ///< pathfinder settings for the new pathfinder
 	YAPFSettings yapf;                       ///< pathfinder settings for the yet another pathfinder
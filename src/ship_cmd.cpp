@@ -359,7 +359,7 @@ static bool CheckShipLeaveDepot(Ship *v)
 
 	/* Don't leave depot if another vehicle is already entering/leaving */
 	/* This helps avoid CPU load if many ships are set to start at the same time */
-	if (HasVehicleOnPos(v->tile, nullptr, &EnsureNoMovingShipProc)) return true;
+	if (HasVehicleOnPos(v->tile, VEH_SHIP, nullptr, &EnsureNoMovingShipProc)) return true;
 
 	TileIndex tile = v->tile;
 	Axis axis = GetShipDepotAxis(tile);
@@ -490,6 +490,7 @@ static Track ChooseShipTrack(Ship *v, TileIndex tile, DiagDirection enterdir, Tr
 			v->path.clear();
 		}
 
+		PerformanceAccumulator framerate(PFE_GL_PF_SHIPS);
 		switch (_settings_game.pf.pathfinder_for_ships) {
 			case VPF_NPF: track = NPFShipChooseTrack(v, path_found); break;
 			case VPF_YAPF: track = YapfShipChooseTrack(v, tile, enterdir, tracks, path_found, v->path); break;
@@ -799,8 +800,8 @@ static void ShipController(Ship *v)
 
 				/* Try to avoid collision and keep distance between each other. */
 				if (_settings_game.pf.forbid_90_deg && DistanceManhattan(v->dest_tile, gp.new_tile) > 3) {
-					if (HasVehicleOnPos(gp.new_tile, NULL, &FindShipOnTile) ||
-							HasVehicleOnPos(TileAddByDiagDir(gp.new_tile, _diagdir_to_next_tile[track][diagdir]), NULL, &FindShipOnTile)) {
+					if (HasVehicleOnPos(gp.new_tile, VEH_SHIP, NULL, &FindShipOnTile) ||
+							HasVehicleOnPos(TileAddByDiagDir(gp.new_tile, _diagdir_to_next_tile[track][diagdir]), VEH_SHIP, NULL, &FindShipOnTile)) {
 
 						v->cur_speed /= 4; // Go quarter speed.
 
@@ -47,6 +47,20 @@ void RebuildStationKdtree()
 	_station_kdtree.Build(stids.begin(), stids.end());
 }
 
+/** Stations that have at least one vehicle in their loading_vehicles list, ordered by index. */
+std::set<StationID> _loading_stations;
+
+/**
+ * Rebuild the set of stations with loading vehicles from the stations' loading lists.
+ */
+void RebuildLoadingStations()
+{
+	_loading_stations.clear();
+	for (const Station *st : Station::Iterate()) {
+		if (!st->loading_vehicles.empty()) _loading_stations.insert(st->index);
+	}
+}
+
 
 BaseStation::~BaseStation()
 {
@@ -68,7 +82,8 @@ Station::Station(TileIndex tile) :
 	indtype(IT_INVALID),
 	time_since_load(255),
 	time_since_unload(255),
-	last_vehicle_type(VEH_INVALID)
+	last_vehicle_type(VEH_INVALID),
+	rating_cargoes(0)
 {
 	/* this->random_bits is set in Station::AddFacility() */
 }
@@ -86,6 +101,7 @@ Station::~Station()
 		for (CargoID c = 0; c < NUM_CARGO; c++) {
 			this->goods[c].cargo.OnCleanPool();
 		}
+		_loading_stations.clear();
 		return;
 	}
 
@@ -236,6 +252,37 @@ void Station::AddFacility(StationFacility new_facility_bit, TileIndex facil_xy)
 	this->build_date = TimerGameCalendar::date;
 }
 
+/**
+ * Append a vehicle to the queue of vehicles loading at this station.
+ * @param v The front vehicle that starts loading.
+ */
+void Station::AddLoadingVehicle(Vehicle *v)
+{
+	this->loading_vehicles.push_back(v);
+	_loading_stations.insert(this->index);
+}
+
+/**
+ * Remove a vehicle from the queue of vehicles loading at this station.
+ * @param v The front vehicle that stops loading.
+ */
+void Station::RemoveLoadingVehicle(Vehicle *v)
+{
+	this->loading_vehicles.remove(v);
+	if (this->loading_vehicles.empty()) _loading_stations.erase(this->index);
+}
+
+/**
+ * Rebuild the cargo types whose rating needs periodic updates from the goods entries.
+ */
+void Station::RebuildRatingCargoes()
+{
+	this->rating_cargoes = 0;
+	for (CargoID c = 0; c < NUM_CARGO; c++) {
+		if (NeedsRatingUpdate(this->goods[c])) SetBit(this->rating_cargoes, c);
+	}
+}
+
 /**
  * Marks the tiles of the station as dirty.
  *
@@ -477,9 +477,10 @@ public:
 	byte time_since_unload;
 
 	byte last_vehicle_type;
-	std::list<Vehicle *> loading_vehicles;
+	std::list<Vehicle *> loading_vehicles; ///< Vehicles loading at this station, in the order they arrived. Modify only via AddLoadingVehicle/RemoveLoadingVehicle.
 	GoodsEntry goods[NUM_CARGO];  ///< Goods at this station
 	CargoTypes always_accepted;       ///< Bitmask of always accepted cargo types (by houses, HQs, industry tiles when industry doesn't accept cargo)
+	CargoTypes rating_cargoes;        ///< NOSAVE: Cargo types whose rating may need a periodic update, i.e. that are rated or recovering from a penalty. @see UpdateStationRating()
 
 	IndustryList industries_near; ///< Cached list of industries near the station that can accept cargo, @see DeliverGoodsToIndustry()
 	Industry *industry;           ///< NOSAVE: Associated industry for neutral stations. (Rebuilt on load from Industry->st)
@@ -491,6 +492,21 @@ public:
 
 	void MarkTilesDirty(bool cargo_change) const;
 
+	void AddLoadingVehicle(Vehicle *v);
+	void RemoveLoadingVehicle(Vehicle *v);
+
+	/**
+	 * Does the rating of the given cargo type need periodic updates?
+	 * @param ge The goods entry of the cargo type.
+	 * @return True iff the cargo is rated or its rating is recovering.
+	 */
+	static inline bool NeedsRatingUpdate(const GoodsEntry &ge)
+	{
+		return ge.HasRating() || ge.rating < INITIAL_STATION_RATING;
+	}
+
+	void RebuildRatingCargoes();
+
 	void UpdateVirtCoord() override;
 
 	void MoveSign(TileIndex new_xy) override;
@@ -566,6 +582,9 @@ public:
 
 void RebuildStationKdtree();
 
+extern std::set<StationID> _loading_stations;
+void RebuildLoadingStations();
+
 /**
  * Call a function on all stations that have any part of the requested area within their catchment.
  * @tparam Func The type of funcion to call
@@ -2067,6 +2067,7 @@ CommandCost CmdBuildRoadStop(DoCommandFlag flags, TileIndex tile, uint8_t width,
 			UpdateCompanyRoadInfrastructure(road_rt, road_owner, ROAD_STOP_TRACKBIT_FACTOR);
 			UpdateCompanyRoadInfrastructure(tram_rt, tram_owner, ROAD_STOP_TRACKBIT_FACTOR);
 			Company::Get(st->owner)->infrastructure.station++;
+			YapfNotifyRoadLayoutChange(cur_tile);
 
 			SetCustomRoadStopSpecIndex(cur_tile, specindex);
 			if (roadstopspec != nullptr) {
@@ -2135,7 +2136,7 @@ static CommandCost RemoveRoadStop(TileIndex tile, DoCommandFlag flags, int repla
 	/* don't do the check for drive-through road stops when company bankrupts */
 	if (IsDriveThroughStopTile(tile) && (flags & DC_BANKRUPT)) {
 		/* remove the 'going through road stop' status from all vehicles on that tile */
-		if (flags & DC_EXEC) FindVehicleOnPos(tile, nullptr, &ClearRoadStopStatusEnum);
+		if (flags & DC_EXEC) FindVehicleOnPos(tile, VEH_ROAD, nullptr, &ClearRoadStopStatusEnum);
 	} else {
 		CommandCost ret = EnsureNoVehicleOnGround(tile);
 		if (ret.Failed()) return ret;
@@ -2179,6 +2180,7 @@ static CommandCost RemoveRoadStop(TileIndex tile, DoCommandFlag flags, int repla
 		} else {
 			DoClearSquare(tile);
 		}
+		YapfNotifyRoadLayoutChange(tile);
 
 		delete cur_stop;
 
@@ -3591,6 +3593,8 @@ static bool StationHandleBigTick(BaseStation *st)
 
 		for (CargoID i = 0; i < NUM_CARGO; i++) {
 			ClrBit(Station::From(st)->goods[i].status, GoodsEntry::GES_ACCEPTED_BIGTICK);
+			/* Rerouted cargo is not merged on arrival, so merge it now before it fragments into many packets. */
+			Station::From(st)->goods[i].cargo.Compact();
 		}
 	}
 
@@ -3635,8 +3639,12 @@ static void UpdateStationRating(Station *st)
 	byte_inc_sat(&st->time_since_load);
 	byte_inc_sat(&st->time_since_unload);
 
-	for (const CargoSpec *cs : CargoSpec::Iterate()) {
-		GoodsEntry *ge = &st->goods[cs->Index()];
+	/* Only look at the cargo types that are rated or recovering; for all others there is nothing to do. */
+	for (CargoID c : SetCargoBitIterator(st->rating_cargoes)) {
+		const CargoSpec *cs = CargoSpec::Get(c);
+		if (!cs->IsValid()) continue;
+
+		GoodsEntry *ge = &st->goods[c];
 		/* Slowly increase the rating back to its original level in the case we
 		 *  didn't deliver cargo yet to this station. This happens when a bribe
 		 *  failed while you didn't moved that cargo yet to a station. */
@@ -3644,11 +3652,15 @@ static void UpdateStationRating(Station *st)
 			ge->rating++;
 		}
 
+		/* Nothing to do anymore until the cargo gets rated, or its rating is lowered. */
+		if (!Station::NeedsRatingUpdate(*ge)) ClrBit(st->rating_cargoes, c);
+
 		/* Only change the rating if we are moving this cargo */
 		if (ge->HasRating()) {
 			byte_inc_sat(&ge->time_since_pickup);
 			if (ge->time_since_pickup == 255 && _settings_game.order.selectgoods) {
 				ClrBit(ge->status, GoodsEntry::GES_RATING);
+				if (!Station::NeedsRatingUpdate(*ge)) ClrBit(st->rating_cargoes, c);
 				ge->last_speed = 0;
 				TruncateCargo(cs, ge);
 				waiting_changed = true;
@@ -4039,6 +4051,7 @@ void ModifyStationRatingAround(TileIndex tile, Owner owner, int amount, uint rad
 
 				if (ge->status != 0) {
 					ge->rating = ClampTo<uint8_t>(ge->rating + amount);
+					if (Station::NeedsRatingUpdate(*ge)) SetBit(st->rating_cargoes, i);
 				}
 			}
 		}
@@ -4079,6 +4092,7 @@ static uint UpdateStationWaiting(Station *st, CargoID type, uint amount, SourceT
 	if (!ge.HasRating()) {
 		InvalidateWindowData(WC_STATION_LIST, st->index);
 		SetBit(ge.status, GoodsEntry::GES_RATING);
+		SetBit(st->rating_cargoes, type);
 	}
 
 	TriggerStationRandomisation(st, st->xy, SRT_NEW_CARGO, type);
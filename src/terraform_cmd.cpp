@@ -309,6 +309,13 @@ std::tuple<CommandCost, Money, TileIndex> CmdTerraformLand(DoCommandFlag flags,
 			int height = it.second;
 
 			SetTileHeight(t, (uint)height);
+
+			/* The slopes of the tiles around the changed corner change, and with them the trackdirs on water. */
+			for (uint dx = 0; dx <= 1 && dx <= TileX(t); dx++) {
+				for (uint dy = 0; dy <= 1 && dy <= TileY(t); dy++) {
+					InvalidateTrackStatusCache(TileXY(TileX(t) - dx, TileY(t) - dy));
+				}
+			}
 		}
 
 		if (c != nullptr) c->terraform_limit -= (uint32_t)ts.tile_to_new_height.size() << 16;
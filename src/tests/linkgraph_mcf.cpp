@@ -0,0 +1,132 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file linkgraph_mcf.cpp Tests and benchmarks of the link graph calculation. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../linkgraph/linkgraphjob.h"
+#include "../linkgraph/linkgraphschedule.h"
+#include "../linkgraph/mcf.h"
+#include "../map_func.h"
+#include "../settings_type.h"
+
+#include <thread>
+#include <tuple>
+
+/** Size of the map the stations of the test graphs are on. */
+static const uint MAP_SIZE = 512;
+
+/**
+ * Create a link graph with stations on a jittered grid, linked to their
+ * neighbours in both directions and by some random long distance links.
+ * @param size Number of nodes.
+ * @return The link graph.
+ */
+static LinkGraph *CreateTestGraph(uint size)
+{
+	if (Map::SizeX() != MAP_SIZE || Map::SizeY() != MAP_SIZE) Map::Allocate(MAP_SIZE, MAP_SIZE);
+
+	REQUIRE(LinkGraph::CanAllocateItem());
+	LinkGraph *lg = new LinkGraph(0);
+	lg->Init(size);
+
+	uint32_t seed = 4711;
+	auto random = [&seed](uint limit) {
+		seed = seed * 1103515245U + 12345U;
+		return (seed >> 8) % limit;
+	};
+
+	uint columns = 1;
+	while (columns * columns < size) columns++;
+	const uint spacing = (MAP_SIZE - 2) / columns;
+	for (NodeID i = 0; i < size; ++i) {
+		LinkGraph::BaseNode &node = (*lg)[i];
+		node.station = i;
+		node.xy = TileXY(1 + (i % columns) * spacing + random(spacing), 1 + (i / columns) * spacing + random(spacing));
+		node.supply = 10 + random(200);
+		node.demand = 1;
+	}
+
+	auto link = [&](NodeID from, NodeID to) {
+		if (from == to || (*lg)[from].HasEdgeTo(to)) return;
+		uint capacity = 50 + random(450);
+		uint time = DistanceManhattan((*lg)[from].xy, (*lg)[to].xy) * 10;
+		(*lg)[from].AddEdge(to, capacity, random(capacity), time, EUM_INCREASE);
+		(*lg)[to].AddEdge(from, capacity, random(capacity), time, EUM_INCREASE);
+	};
+	for (NodeID i = 0; i < size; ++i) {
+		if (i % columns + 1 < columns && i + 1u < size) link(i, i + 1);
+		if (i + columns < size) link(i, i + columns);
+		if (random(8) == 0) link(i, random(size));
+	}
+	return lg;
+}
+
+/** Planned flow of some cargo from an origin through a node to the next hop. */
+using TestFlow = std::tuple<NodeID, StationID, uint32_t, StationID>;
+
+/**
+ * Run a link graph through all the handlers, like a link graph job thread does.
+ * @param lg The link graph.
+ * @param threads Number of extra threads searching paths.
+ * @return The flows planned at all nodes.
+ */
+static std::vector<TestFlow> CalculateFlows(const LinkGraph &lg, uint threads)
+{
+	_settings_game.linkgraph.recalc_time = 16 * SECONDS_PER_DAY;
+	_settings_game.linkgraph.distribution_pax = DT_SYMMETRIC;
+	_settings_game.linkgraph.distribution_mail = DT_SYMMETRIC;
+	_settings_game.linkgraph.distribution_armoured = DT_SYMMETRIC;
+	_settings_game.linkgraph.distribution_default = DT_SYMMETRIC;
+	_settings_game.linkgraph.accuracy = 16;
+	_settings_game.linkgraph.demand_size = 100;
+	_settings_game.linkgraph.demand_distance = 100;
+	_settings_game.linkgraph.short_path_saturation = 80;
+	_linkgraph_threads = threads;
+
+	REQUIRE(LinkGraphJob::CanAllocateItem());
+	LinkGraphJob *job = new LinkGraphJob(lg);
+	LinkGraphSchedule::Run(job);
+
+	std::vector<TestFlow> flows;
+	for (NodeID node = 0; node < job->Size(); ++node) {
+		for (const auto &flow : (*job)[node].flows) {
+			for (const auto &share : *flow.second.GetShares()) {
+				flows.emplace_back(node, flow.first, share.first, share.second);
+			}
+		}
+	}
+	/* There are no stations, so this just drops the flows. */
+	delete job;
+	return flows;
+}
+
+TEST_CASE("MultiCommodityFlow - The flows do not depend on the number of threads")
+{
+	LinkGraph *lg = CreateTestGraph(100);
+	std::vector<TestFlow> flows = CalculateFlows(*lg, 0);
+	CHECK(!flows.empty());
+	CHECK(CalculateFlows(*lg, 3) == flows);
+	delete lg;
+	_linkgraph_threads = 0;
+}
+
+TEST_CASE("MultiCommodityFlow - Demands, MCF and flow mapping of 5000 nodes", "[.][benchmark]")
+{
+	/* One run takes long; use --benchmark-samples to limit the number of runs. */
+	LinkGraph *lg = CreateTestGraph(5000);
+	for (uint threads : { 0u, std::max(std::thread::hardware_concurrency(), 1u) - 1 }) {
+		BENCHMARK("Calculate flows with " + std::to_string(threads) + " extra threads") {
+			return CalculateFlows(*lg, threads).size();
+		};
+	}
+	delete lg;
+	_linkgraph_threads = 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file npf_aystar.cpp Tests of AyStar, and of its priority queue and node index. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../pathfinder/npf/aystar.h"
+
+#include <queue>
+
+TEST_CASE("QuaternaryHeap - Nodes come out by priority, also after an update")
+{
+	QuaternaryHeap heap;
+	std::vector<int> priorities;
+	for (uint32_t node = 0; node < 1000; node++) {
+		priorities.push_back((node * 7919) % 1009);
+		heap.Push(node, priorities.back());
+	}
+
+	/* Lower the priority of every third node, and raise it of every fifth. */
+	for (uint32_t node = 0; node < 1000; node += 3) heap.Update(node, priorities[node] -= 500);
+	for (uint32_t node = 0; node < 1000; node += 5) heap.Update(node, priorities[node] += 700);
+
+	bool in_order = true;
+	int last = INT_MIN;
+	uint count = 0;
+	while (!heap.IsEmpty()) {
+		int priority = priorities[heap.Pop()];
+		if (priority < last) in_order = false;
+		last = priority;
+		count++;
+	}
+	CHECK(in_order);
+	CHECK(count == 1000);
+
+	/* Popped nodes can be pushed again. */
+	heap.Push(5, 1);
+	CHECK(heap.Pop() == 5);
+}
+
+TEST_CASE("AyStarNodeIndex - Clearing starts a new generation")
+{
+	AyStarNodeIndex index;
+	index.Init(4);
+	for (uint32_t i = 0; i < 5000; i++) {
+		AyStarNodeIndex::Slot &slot = index.Insert(TileIndex{i / 2}, (Trackdir)(i % 2));
+		slot.list = AyStarList::Open;
+		slot.node = i;
+	}
+
+	bool all_found = true;
+	for (uint32_t i = 0; i < 5000; i++) {
+		AyStarNodeIndex::Slot *slot = index.Find(TileIndex{i / 2}, (Trackdir)(i % 2));
+		if (slot == nullptr || slot->node != i) all_found = false;
+	}
+	CHECK(all_found);
+	CHECK(index.Find(TileIndex{1}, TRACKDIR_RIGHT_N) == nullptr);
+
+	index.Clear();
+	CHECK(index.Find(TileIndex{0}, TRACKDIR_X_NE) == nullptr);
+	index.Insert(TileIndex{0}, TRACKDIR_X_NE).node = 42;
+	CHECK(index.Find(TileIndex{0}, TRACKDIR_X_NE)->node == 42);
+}
+
+static const uint GRID_SIZE = 64; ///< Width and height of the grid searched by the AyStar test.
+
+/** Offsets of the neighbouring cells of the test grid. */
+static const int _grid_offsets[] = { 1, (int)GRID_SIZE, -1, -(int)GRID_SIZE };
+
+/** Whether a cell of the test grid is blocked; the border and a pattern of walls with gaps are. */
+static bool IsGridBlocked(uint32_t cell)
+{
+	uint x = cell % GRID_SIZE;
+	uint y = cell / GRID_SIZE;
+	if (x == 0 || y == 0 || x == GRID_SIZE - 1 || y == GRID_SIZE - 1) return true;
+	return (x % 8 == 4 && y % 16 != 7) || (y % 8 == 2 && x % 16 != 11);
+}
+
+static int32_t Grid_EndNodeCheck(const AyStar *aystar, const OpenListNode *current)
+{
+	return current->path.node.tile == *(TileIndex *)aystar->user_target ? AYSTAR_FOUND_END_NODE : AYSTAR_DONE;
+}
+
+static int32_t Grid_CalculateG(AyStar *, AyStarNode *, OpenListNode *)
+{
+	return 1;
+}
+
+static int32_t Grid_CalculateH(AyStar *aystar, AyStarNode *current, OpenListNode *)
+{
+	uint32_t cell = current->tile;
+	uint32_t dest = *(TileIndex *)aystar->user_target;
+	return abs((int)(cell % GRID_SIZE) - (int)(dest % GRID_SIZE)) + abs((int)(cell / GRID_SIZE) - (int)(dest / GRID_SIZE));
+}
+
+static void Grid_GetNeighbours(AyStar *aystar, OpenListNode *current)
+{
+	aystar->num_neighbours = 0;
+	for (int offset : _grid_offsets) {
+		uint32_t cell = current->path.node.tile + offset;
+		if (IsGridBlocked(cell)) continue;
+		AyStarNode &neighbour = aystar->neighbours[aystar->num_neighbours++];
+		neighbour = {};
+		neighbour.tile = TileIndex{cell};
+		neighbour.direction = INVALID_TRACKDIR;
+	}
+}
+
+static void Grid_FoundEndNode(AyStar *aystar, OpenListNode *current)
+{
+	int steps = 0;
+	for (PathNode *path = current->path.parent; path != nullptr; path = path->parent) steps++;
+	*(std::pair<int, int> *)aystar->user_path = { current->g, steps };
+}
+
+/** Least number of steps between two cells by a breadth first search, or -1 when there is no way. */
+static int GridDistance(uint32_t origin, uint32_t dest)
+{
+	std::vector<int> dist(GRID_SIZE * GRID_SIZE, -1);
+	std::queue<uint32_t> queue;
+	dist[origin] = 0;
+	queue.push(origin);
+	while (!queue.empty()) {
+		uint32_t cell = queue.front();
+		queue.pop();
+		if (cell == dest) return dist[cell];
+		for (int offset : _grid_offsets) {
+			uint32_t next = cell + offset;
+			if (IsGridBlocked(next) || dist[next] >= 0) continue;
+			dist[next] = dist[cell] + 1;
+			queue.push(next);
+		}
+	}
+	return -1;
+}
+
+TEST_CASE("AyStar - Searches on a grid find the least cost, also when reusing the instance")
+{
+	AyStar finder = {};
+	finder.CalculateG = Grid_CalculateG;
+	finder.CalculateH = Grid_CalculateH;
+	finder.GetNeighbours = Grid_GetNeighbours;
+	finder.EndNodeCheck = Grid_EndNodeCheck;
+	finder.FoundEndNode = Grid_FoundEndNode;
+	finder.Init(16);
+
+	bool all_equal = true;
+	uint32_t seed = 4321;
+	for (int query = 0; query < 50; query++) {
+		uint32_t cells[2];
+		for (uint32_t &cell : cells) {
+			do {
+				seed = seed * 1103515245U + 12345U;
+				cell = (seed >> 8) % (GRID_SIZE * GRID_SIZE);
+			} while (IsGridBlocked(cell));
+		}
+
+		TileIndex dest{cells[1]};
+		std::pair<int, int> result = { -1, -1 };
+		finder.user_target = &dest;
+		finder.user_path = &result;
+
+		AyStarNode start = {};
+		start.tile = TileIndex{cells[0]};
+		start.direction = INVALID_TRACKDIR;
+		finder.AddStartNode(&start, 0);
+		finder.Main();
+
+		int expected = GridDistance(cells[0], cells[1]);
+		if (result.first != expected || result.second != expected) all_equal = false;
+	}
+	finder.Free();
+	CHECK(all_equal);
+}
@@ -0,0 +1,218 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file yapf_nodelist.cpp Tests and benchmarks of the node list of YAPF. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../pathfinder/yapf/nodelist.hpp"
+
+#include <queue>
+
+static const uint MAP_SIZE = 128; ///< Width and height of the test map.
+static const int STEP_COST = 10;  ///< Cost of a step from one tile to the next.
+
+/** Key of a test node: a tile and the direction it was entered from, like the trackdir of a YAPF node. */
+struct TestNodeKey {
+	uint32_t tile;
+	uint8_t dir;
+
+	inline int CalcHash() const
+	{
+		return dir | (tile << 2);
+	}
+
+	inline bool operator==(const TestNodeKey &other) const
+	{
+		return tile == other.tile && dir == other.dir;
+	}
+};
+
+/** Node of the test searches, with the members YAPF nodes use. */
+struct TestNode {
+	typedef TestNodeKey Key;
+
+	TestNodeKey m_key;
+	TestNode *m_parent;
+	int m_cost;
+	int m_estimate;
+
+	inline const Key &GetKey() const
+	{
+		return m_key;
+	}
+
+	inline bool operator<(const TestNode &other) const
+	{
+		return m_estimate < other.m_estimate;
+	}
+};
+
+typedef CNodeList_HashTableT<TestNode, 8, 10> TestNodeList;
+
+/** Offsets of the tiles in the four directions. */
+static const int _test_offsets[] = { 1, (int)MAP_SIZE, -1, -(int)MAP_SIZE };
+
+/** Whether a tile of the test map is blocked; the border and about a quarter of the other tiles are. */
+static bool IsBlocked(uint32_t tile)
+{
+	uint x = tile % MAP_SIZE;
+	uint y = tile / MAP_SIZE;
+	if (x == 0 || y == 0 || x == MAP_SIZE - 1 || y == MAP_SIZE - 1) return true;
+	uint32_t h = x * 73856093U ^ y * 19349663U;
+	h ^= h >> 13;
+	h *= 0x5BD1E995U;
+	h ^= h >> 15;
+	return h % 4 == 0;
+}
+
+/** Estimate of the cost from a tile to the destination. */
+static int Estimate(uint32_t tile, uint32_t dest)
+{
+	int dx = (int)(tile % MAP_SIZE) - (int)(dest % MAP_SIZE);
+	int dy = (int)(tile / MAP_SIZE) - (int)(dest / MAP_SIZE);
+	return (abs(dx) + abs(dy)) * STEP_COST;
+}
+
+/**
+ * Search the least cost between two tiles with A*, using the node list the
+ * same way CYapfBaseT does.
+ * @return The least cost, or -1 when the destination can't be reached.
+ */
+static int FindPathWithNodeList(uint32_t origin, uint32_t dest)
+{
+	TestNodeList nodes;
+	TestNode &first = *nodes.CreateNewNode();
+	first = { { origin, 0 }, nullptr, 0, Estimate(origin, dest) };
+	nodes.InsertOpenNode(first);
+
+	for (;;) {
+		TestNode *n = nodes.GetBestOpenNode();
+		if (n == nullptr) return -1;
+		if (n->m_key.tile == dest) return n->m_cost;
+
+		for (uint8_t dir = 0; dir < 4; dir++) {
+			uint32_t tile = n->m_key.tile + _test_offsets[dir];
+			if (IsBlocked(tile)) continue;
+
+			TestNode &node = *nodes.CreateNewNode();
+			node = { { tile, dir }, n, n->m_cost + STEP_COST, 0 };
+			node.m_estimate = node.m_cost + Estimate(tile, dest);
+
+			TestNode *open_node = nodes.FindOpenNode(node.GetKey());
+			if (open_node != nullptr) {
+				if (node.m_estimate < open_node->m_estimate) {
+					nodes.PopOpenNode(node.GetKey());
+					*open_node = node;
+					nodes.InsertOpenNode(*open_node);
+				}
+				continue;
+			}
+			if (nodes.FindClosedNode(node.GetKey()) != nullptr) continue;
+			nodes.InsertOpenNode(node);
+		}
+
+		nodes.PopOpenNode(n->GetKey());
+		nodes.InsertClosedNode(*n);
+	}
+}
+
+/** Least cost between two tiles by a breadth first search, to check the results of the node list. */
+static int FindPathReference(uint32_t origin, uint32_t dest)
+{
+	std::vector<int> dist(MAP_SIZE * MAP_SIZE, -1);
+	std::queue<uint32_t> queue;
+	dist[origin] = 0;
+	queue.push(origin);
+	while (!queue.empty()) {
+		uint32_t tile = queue.front();
+		queue.pop();
+		if (tile == dest) return dist[tile];
+		for (int offset : _test_offsets) {
+			uint32_t next = tile + offset;
+			if (IsBlocked(next) || dist[next] >= 0) continue;
+			dist[next] = dist[tile] + STEP_COST;
+			queue.push(next);
+		}
+	}
+	return -1;
+}
+
+/** The queries replayed by the tests: a fixed set of open tiles to search between. */
+static std::vector<std::pair<uint32_t, uint32_t>> GetTestQueries()
+{
+	std::vector<std::pair<uint32_t, uint32_t>> queries;
+	uint32_t seed = 12345;
+	auto next_open_tile = [&seed]() {
+		for (;;) {
+			seed = seed * 1103515245U + 12345U;
+			uint32_t tile = (seed >> 8) % (MAP_SIZE * MAP_SIZE);
+			if (!IsBlocked(tile)) return tile;
+		}
+	};
+	while (queries.size() < 64) {
+		uint32_t origin = next_open_tile();
+		queries.emplace_back(origin, next_open_tile());
+	}
+	return queries;
+}
+
+TEST_CASE("COpenHashTableT - Find and insert")
+{
+	COpenHashTableT<TestNodeKey, int> table;
+	for (uint32_t i = 0; i < 5000; i++) table.FindOrInsert({ i, (uint8_t)(i % 4) }) = i;
+	CHECK(table.Count() == 5000);
+
+	bool all_found = true;
+	for (uint32_t i = 0; i < 5000; i++) {
+		int *value = table.Find({ i, (uint8_t)(i % 4) });
+		if (value == nullptr || *value != (int)i) all_found = false;
+	}
+	CHECK(all_found);
+	CHECK(table.Find({ 1, 0 }) == nullptr);
+	CHECK(table.FindOrInsert({ 7, 3 }) == 7);
+	CHECK(table.Count() == 5000);
+
+	table.Clear();
+	CHECK(table.Count() == 0);
+	CHECK(table.Find({ 7, 3 }) == nullptr);
+}
+
+TEST_CASE("CNodeList_HashTableT - Replayed searches find the least cost")
+{
+	bool all_equal = true;
+	for (const auto &query : GetTestQueries()) {
+		if (FindPathWithNodeList(query.first, query.second) != FindPathReference(query.first, query.second)) all_equal = false;
+	}
+	CHECK(all_equal);
+}
+
+TEST_CASE("CNodeList_HashTableT - Nested node lists do not share memory")
+{
+	auto queries = GetTestQueries();
+	TestNodeList outer;
+	TestNode *node = outer.CreateNewNode();
+	*node = { { queries[0].first, 0 }, nullptr, 0, 0 };
+	outer.InsertOpenNode(*node);
+
+	CHECK(FindPathWithNodeList(queries[1].first, queries[1].second) == FindPathReference(queries[1].first, queries[1].second));
+	CHECK(outer.FindOpenNode(node->GetKey()) == node);
+	CHECK(outer.OpenCount() == 1);
+	CHECK(outer.TotalCount() == 1);
+}
+
+TEST_CASE("CNodeList_HashTableT - Replayed searches", "[.][benchmark]")
+{
+	auto queries = GetTestQueries();
+	BENCHMARK("Replay queries") {
+		int total = 0;
+		for (const auto &query : queries) total += FindPathWithNodeList(query.first, query.second);
+		return total;
+	};
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file thread_pool.cpp Implementation of the pool of worker threads. */
+
+#include "stdafx.h"
+#include "thread.h"
+#include "thread_pool.h"
+
+#include "safeguards.h"
+
+/**
+ * Create a pool without any worker threads; batches run on the calling thread until it is resized.
+ * @param name Name of the worker threads.
+ */
+ThreadPool::ThreadPool(const char *name) : name(name)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+	this->Resize(0);
+}
+
+/**
+ * Change the number of worker threads.
+ * @param num_workers The number of worker threads; 0 runs all tasks on the thread starting the batch.
+ */
+void ThreadPool::Resize(uint num_workers)
+{
+	if (num_workers == this->workers.size()) return;
+
+	if (!this->workers.empty()) {
+		{
+			std::lock_guard<std::mutex> guard(this->lock);
+			this->stop = true;
+		}
+		this->work_cv.notify_all();
+		for (std::thread &worker : this->workers) worker.join();
+		this->workers.clear();
+		this->stop = false;
+	}
+
+	for (uint i = 0; i < num_workers; i++) {
+		std::thread worker;
+		const uint64_t generation = this->generation;
+		if (!StartNewThread(&worker, this->name, [this, generation]() { this->WorkerLoop(generation); })) break;
+		this->workers.push_back(std::move(worker));
+	}
+}
+
+/**
+ * Run a batch of tasks on the worker threads and the calling thread.
+ * Returns when all tasks are finished. The order in which the tasks run is
+ * undefined, so the tasks must not depend on each other.
+ * @param count Number of tasks.
+ * @param func Function to run for each task.
+ */
+void ThreadPool::RunBatch(size_t count, const TaskFunc &func)
+{
+	if (count == 0) return;
+
+	if (this->workers.empty() || count == 1) {
+		for (size_t i = 0; i < count; i++) func(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->func = &func;
+		this->count = count;
+		this->next_task = 0;
+		this->busy_workers = (uint)this->workers.size();
+		this->generation++;
+	}
+	this->work_cv.notify_all();
+
+	this->RunTasks();
+
+	std::unique_lock<std::mutex> guard(this->lock);
+	this->done_cv.wait(guard, [this]() { return this->busy_workers == 0; });
+	this->func = nullptr;
+}
+
+/** Run tasks of the current batch until none are left. */
+void ThreadPool::RunTasks()
+{
+	for (;;) {
+		size_t index = this->next_task.fetch_add(1, std::memory_order_relaxed);
+		if (index >= this->count) return;
+		(*this->func)(index);
+	}
+}
+
+/**
+ * Main loop of a worker thread: wait for a batch, help running it, repeat.
+ * @param last_generation Number of the last batch before the worker was started.
+ */
+void ThreadPool::WorkerLoop(uint64_t last_generation)
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> guard(this->lock);
+			this->work_cv.wait(guard, [&]() { return this->stop || this->generation != last_generation; });
+			if (this->stop) return;
+			last_generation = this->generation;
+		}
+
+		this->RunTasks();
+
+		std::lock_guard<std::mutex> guard(this->lock);
+		if (--this->busy_workers == 0) this->done_cv.notify_one();
+	}
+}
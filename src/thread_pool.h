@@ -0,0 +1,61 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file thread_pool.h A pool of worker threads for running batches of independent tasks. */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * A set of worker threads that run batches of independent tasks. The thread
+ * starting a batch takes part in it and waits until all its tasks are done,
+ * so the tasks may read game state as long as nothing modifies it meanwhile.
+ */
+class ThreadPool {
+public:
+	/** Function run for each task of a batch, with the index of the task. */
+	using TaskFunc = std::function<void(size_t index)>;
+
+	ThreadPool(const char *name);
+	~ThreadPool();
+
+	void Resize(uint num_workers);
+
+	/**
+	 * Get the number of worker threads, not counting the thread that starts batches.
+	 * @return The number of worker threads.
+	 */
+	uint GetNumWorkers() const { return (uint)this->workers.size(); }
+
+	void RunBatch(size_t count, const TaskFunc &func);
+
+private:
+	const char *name;                    ///< Name of the worker threads.
+	std::vector<std::thread> workers;    ///< The worker threads.
+
+	std::mutex lock;                     ///< Lock for all members below.
+	std::condition_variable work_cv;     ///< Signalled when a batch starts or the workers have to stop.
+	std::condition_variable done_cv;     ///< Signalled when the last worker leaves a batch.
+	uint64_t generation = 0;             ///< Number of the current batch.
+	bool stop = false;                   ///< Whether the workers have to stop.
+	uint busy_workers = 0;               ///< Number of workers still working on the current batch.
+
+	const TaskFunc *func = nullptr;      ///< Function of the current batch.
+	size_t count = 0;                    ///< Number of tasks of the current batch.
+	std::atomic<size_t> next_task = 0;   ///< Index of the next task to run.
+
+	void RunTasks();
+	void WorkerLoop(uint64_t last_generation);
+};
+
+#endif /* THREAD_POOL_H */
@@ -14,6 +14,8 @@
 #include "map_func.h"
 #include "core/bitmath_func.hpp"
 #include "settings_type.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/track_status_cache.h"
 
 /**
  * Returns the height of a tile
@@ -136,6 +138,9 @@ static inline void SetTileType(Tile tile, TileType type)
 	 * the upper edges of the map are also VOID tiles. */
 	assert(IsInnerTile(tile) == (type != MP_VOID));
 	SB(tile.type(), 4, 4, type);
+	/* Every change of tile type may add or remove water tracks, and tracks of any other kind. */
+	InvalidateWaterRegion(tile);
+	InvalidateTrackStatusCache(tile);
 }
 
 /**
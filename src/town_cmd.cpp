@@ -51,6 +51,7 @@
 #include "road_cmd.h"
 #include "terraform_cmd.h"
 #include "tunnelbridge_cmd.h"
+#include "framerate_type.h"
 #include "timer/timer.h"
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_tick.h"
@@ -833,6 +834,8 @@ void OnTick_Town()
 {
 	if (_game_mode == GM_EDITOR) return;
 
+	PerformanceAccumulator framerate(PFE_GL_TOWNS);
+
 	for (Town *t : Town::Iterate()) {
 		TownTickHandler(t);
 	}
@@ -3276,6 +3279,7 @@ static CommandCost TownActionBribe(Town *t, DoCommandFlag flags)
 			for (Station *st : Station::Iterate()) {
 				if (st->town == t && st->owner == _current_company) {
 					for (CargoID i = 0; i < NUM_CARGO; i++) st->goods[i].rating = 0;
+					st->rating_cargoes = ALL_CARGOTYPES;
 				}
 			}
 
@@ -68,6 +68,10 @@ void GetTrainSpriteSize(EngineID engine, uint &width, uint &height, int &xoffs,
 bool TrainOnCrossing(TileIndex tile);
 void NormalizeTrainVehInDepot(const Train *u);
 
+extern uint _pathfinder_threads;
+void FindServiceDepotsForTrains(size_t first, size_t step);
+void ClearServiceDepotSearches();
+
 /** Variables that are cached to improve performance and such */
 struct TrainCache {
 	/* Cached wagon override spritegroup */
@@ -39,6 +39,7 @@
 #include "misc_cmd.h"
 #include "timer/timer_game_calendar.h"
 #include "infrastructure_func.h"
+#include "thread_pool.h"
 
 #include "table/strings.h"
 #include "table/train_sprites.h"
@@ -1672,7 +1673,7 @@ bool TrainOnCrossing(TileIndex tile)
 {
 	assert(IsLevelCrossingTile(tile));
 
-	return HasVehicleOnPos(tile, nullptr, &TrainOnTileEnum);
+	return HasVehicleOnPos(tile, VEH_TRAIN, nullptr, &TrainOnTileEnum);
 }
 
 
@@ -1710,12 +1711,12 @@ static bool TrainApproachingCrossing(TileIndex tile)
 	DiagDirection dir = AxisToDiagDir(GetCrossingRailAxis(tile));
 	TileIndex tile_from = tile + TileOffsByDiagDir(dir);
 
-	if (HasVehicleOnPos(tile_from, &tile, &TrainApproachingCrossingEnum)) return true;
+	if (HasVehicleOnPos(tile_from, VEH_TRAIN, &tile, &TrainApproachingCrossingEnum)) return true;
 
 	dir = ReverseDiagDir(dir);
 	tile_from = tile + TileOffsByDiagDir(dir);
 
-	return HasVehicleOnPos(tile_from, &tile, &TrainApproachingCrossingEnum);
+	return HasVehicleOnPos(tile_from, VEH_TRAIN, &tile, &TrainApproachingCrossingEnum);
 }
 
 /**
@@ -2453,6 +2454,7 @@ static Track DoTrainPathfind(const Train *v, TileIndex tile, DiagDirection enter
 {
 	if (final_dest != nullptr) *final_dest = INVALID_TILE;
 
+	PerformanceAccumulator framerate(PFE_GL_PF_TRAINS);
 	switch (_settings_game.pf.pathfinder_for_trains) {
 		case VPF_NPF: return NPFTrainChooseTrack(v, path_found, do_track_reservation, dest);
 		case VPF_YAPF: return YapfTrainChooseTrack(v, tile, enterdir, tracks, path_found, do_track_reservation, dest, final_dest);
@@ -3213,8 +3215,8 @@ static bool CheckTrainCollision(Train *v)
 
 	/* find colliding vehicles */
 	if (v->track == TRACK_BIT_WORMHOLE) {
-		FindVehicleOnPos(v->tile, &tcc, FindTrainCollideEnum);
-		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), &tcc, FindTrainCollideEnum);
+		FindVehicleOnPos(v->tile, VEH_TRAIN, &tcc, FindTrainCollideEnum);
+		FindVehicleOnPos(GetOtherTunnelBridgeEnd(v->tile), VEH_TRAIN, &tcc, FindTrainCollideEnum);
 	} else {
 		FindVehicleOnPosXY(v->x_pos, v->y_pos, &tcc, FindTrainCollideEnum);
 	}
@@ -3362,7 +3364,7 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 								exitdir = ReverseDiagDir(exitdir);
 
 								/* check if a train is waiting on the other side */
-								if (!HasVehicleOnPos(o_tile, &exitdir, &CheckTrainAtSignal)) return false;
+								if (!HasVehicleOnPos(o_tile, VEH_TRAIN, &exitdir, &CheckTrainAtSignal)) return false;
 							}
 						}
 
@@ -3595,10 +3597,10 @@ static bool IsRailStationPlatformOccupied(TileIndex tile)
 	TileIndexDiff delta = (GetRailStationAxis(tile) == AXIS_X ? TileDiffXY(1, 0) : TileDiffXY(0, 1));
 
 	for (TileIndex t = tile; IsCompatibleTrainStationTile(t, tile); t -= delta) {
-		if (HasVehicleOnPos(t, nullptr, &TrainOnTileEnum)) return true;
+		if (HasVehicleOnPos(t, VEH_TRAIN, nullptr, &TrainOnTileEnum)) return true;
 	}
 	for (TileIndex t = tile + delta; IsCompatibleTrainStationTile(t, tile); t += delta) {
-		if (HasVehicleOnPos(t, nullptr, &TrainOnTileEnum)) return true;
+		if (HasVehicleOnPos(t, VEH_TRAIN, nullptr, &TrainOnTileEnum)) return true;
 	}
 
 	return false;
@@ -3652,7 +3654,7 @@ static void DeleteLastWagon(Train *v)
 
 		/* If there are still crashed vehicles on the tile, give the track reservation to them */
 		TrackBits remaining_trackbits = TRACK_BIT_NONE;
-		FindVehicleOnPos(tile, &remaining_trackbits, CollectTrackbitsFromCrashedVehiclesEnum);
+		FindVehicleOnPos(tile, VEH_TRAIN, &remaining_trackbits, CollectTrackbitsFromCrashedVehiclesEnum);
 
 		/* It is important that these two are the first in the loop, as reservation cannot deal with every trackbit combination */
 		assert(TRACK_BEGIN == TRACK_X && TRACK_Y == TRACK_BEGIN + 1);
@@ -4108,6 +4110,60 @@ bool Train::Tick()
 	return true;
 }
 
+uint _pathfinder_threads; ///< Number of extra threads searching paths in parallel; 0 searches on the game loop thread only.
+static ThreadPool _pathfinder_pool("ottd:pathfind"); ///< Threads searching paths in parallel.
+
+/** Depot found for a train by FindServiceDepotsForTrains. */
+using ServiceDepotSearch = std::pair<VehicleID, FindDepotData>;
+/** Depots found for the trains whose day procs run in the current tick, ordered by vehicle index. */
+static std::vector<ServiceDepotSearch> _service_depot_searches;
+
+/**
+ * Search the nearest depots for the trains that are about to check whether
+ * they need servicing in their day procs. These searches do not reserve any
+ * track, and nothing the day procs do changes what they find, so they can run
+ * in parallel on the pathfinder threads beforehand. CheckIfTrainNeedsService
+ * then uses the results in vehicle index order, exactly as if it had searched
+ * itself.
+ * @param first Index of the first vehicle whose day proc runs in this tick.
+ * @param step Distance between the indices of the vehicles whose day procs run.
+ */
+void FindServiceDepotsForTrains(size_t first, size_t step)
+{
+	assert(_service_depot_searches.empty());
+	if (_pathfinder_threads == 0 || _settings_game.pf.pathfinder_for_trains != VPF_YAPF) return;
+	/* The pathfinder's debug output and desync checks are not thread safe. */
+	if (_debug_yapf_level >= 3 || _debug_desync_level >= 2) return;
+
+	for (size_t i = first; i < Vehicle::GetPoolSize(); i += step) {
+		const Train *v = Train::GetIfValid(i);
+		if (v == nullptr || !v->IsFrontEngine() || (v->vehstatus & VS_CRASHED) != 0) continue;
+		if (Company::Get(v->owner)->settings.vehicle.servint_trains == 0 || !v->NeedsAutomaticServicing() || v->IsChainInDepot()) continue;
+		_service_depot_searches.emplace_back(v->index, FindDepotData());
+	}
+	if (_service_depot_searches.size() < 2) {
+		/* Not worth waking up the threads. */
+		_service_depot_searches.clear();
+		return;
+	}
+
+	_pathfinder_pool.Resize(_pathfinder_threads);
+	const uint max_penalty = _settings_game.pf.yapf.maximum_go_to_depot_penalty;
+	_pathfinder_pool.RunBatch(_service_depot_searches.size(), [max_penalty](size_t index) {
+		ServiceDepotSearch &search = _service_depot_searches[index];
+		search.second = FindClosestTrainDepot(Train::Get(search.first), max_penalty);
+	});
+}
+
+/**
+ * Forget the depots found by FindServiceDepotsForTrains once the day procs have run,
+ * as trains moving afterwards would make them outdated.
+ */
+void ClearServiceDepotSearches()
+{
+	_service_depot_searches.clear();
+}
+
 /**
  * Check whether a train needs service, and if so, find a depot or service it.
  * @return v %Train to check.
@@ -4127,7 +4183,14 @@ static void CheckIfTrainNeedsService(Train *v)
 		default: NOT_REACHED();
 	}
 
-	FindDepotData tfdd = FindClosestTrainDepot(v, max_penalty);
+	FindDepotData tfdd;
+	auto search = std::lower_bound(_service_depot_searches.begin(), _service_depot_searches.end(), v->index,
+			[](const ServiceDepotSearch &search, VehicleID index) { return search.first < index; });
+	if (search != _service_depot_searches.end() && search->first == v->index) {
+		tfdd = search->second;
+	} else {
+		tfdd = FindClosestTrainDepot(v, max_penalty);
+	}
 	/* Only go to the depot if it is not too far out of our way. */
 	if (tfdd.best_length == UINT_MAX || tfdd.best_length > max_penalty) {
 		if (v->current_order.IsType(OT_GOTO_DEPOT)) {
@@ -338,6 +338,8 @@ void VehicleLengthChanged(const Vehicle *u)
 	}
 }
 
+static void SetTickVehicle(size_t index, bool tick);
+
 /**
  * Vehicle constructor.
  * @param type Type of the new vehicle.
@@ -354,6 +356,9 @@ Vehicle::Vehicle(VehicleType type)
 	this->cargo_age_counter  = 1;
 	this->last_station_visited = INVALID_STATION;
 	this->last_loading_station = INVALID_STATION;
+
+	/* A new vehicle is not part of any chain yet. */
+	SetTickVehicle(this->index, true);
 }
 
 /* Size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes will (in theory) reduce hash
@@ -368,15 +373,29 @@ const int TOTAL_HASH_MASK = TOTAL_HASH_SIZE - 1;
  * Profiling results show that 0 is fastest. */
 const int HASH_RES = 0;
 
-static Vehicle *_vehicle_tile_hash[TOTAL_HASH_SIZE];
+/**
+ * Entry of the vehicle tile hash. It holds the data that is needed to reject vehicles
+ * without touching them, so walking a bucket stays within one contiguous array.
+ */
+struct VehicleTileHashEntry {
+	TileIndex tile;   ///< The tile of the vehicle when it was last (re)hashed.
+	VehicleType type; ///< The type of the vehicle.
+	Vehicle *v;       ///< The vehicle itself.
+};
+
+/** A bucket of the vehicle tile hash. */
+typedef std::vector<VehicleTileHashEntry> VehicleTileHashBucket;
+
+static VehicleTileHashBucket _vehicle_tile_hash[TOTAL_HASH_SIZE];
 
 static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, void *data, VehicleFromPosProc *proc, bool find_first)
 {
 	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
 		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
-			Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
-			for (; v != nullptr; v = v->hash_tile_next) {
-				Vehicle *a = proc(v, data);
+			const VehicleTileHashBucket &bucket = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+			/* Index the bucket on every iteration; the proc might change the hash. */
+			for (size_t i = 0; i < bucket.size(); i++) {
+				Vehicle *a = proc(bucket[i].v, data);
 				if (find_first && a != nullptr) return a;
 			}
 			if (x == xu) break;
@@ -387,7 +406,6 @@ static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, void *data,
 	return nullptr;
 }
 
-
 /**
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
  * @note Do not call this function directly!
@@ -451,19 +469,26 @@ bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc)
  * Helper function for FindVehicleOnPos/HasVehicleOnPos.
  * @note Do not call this function directly!
  * @param tile The location on the map
+ * @param type The type of vehicles to consider, or #VEH_INVALID for all types.
  * @param data Arbitrary data passed to \a proc.
  * @param proc The proc that determines whether a vehicle will be "found".
  * @param find_first Whether to return on the first found or iterate over
  *                   all vehicles
  * @return the best matching or first vehicle (depending on find_first).
  */
-static Vehicle *VehicleFromPos(TileIndex tile, void *data, VehicleFromPosProc *proc, bool find_first)
+static Vehicle *VehicleFromPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc, bool find_first)
 {
 	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
 	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
 
-	Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
-	for (; v != nullptr; v = v->hash_tile_next) {
+	const VehicleTileHashBucket &bucket = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+	/* Index the bucket on every iteration; the proc might change the hash. */
+	for (size_t i = 0; i < bucket.size(); i++) {
+		const VehicleTileHashEntry &entry = bucket[i];
+		if (entry.tile != tile || (type != VEH_INVALID && entry.type != type)) continue;
+
+		/* The tile of a moving vehicle is changed a bit before it is rehashed. */
+		Vehicle *v = entry.v;
 		if (v->tile != tile) continue;
 
 		Vehicle *a = proc(v, data);
@@ -488,7 +513,21 @@ static Vehicle *VehicleFromPos(TileIndex tile, void *data, VehicleFromPosProc *p
  */
 void FindVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc)
 {
-	VehicleFromPos(tile, data, proc, false);
+	VehicleFromPos(tile, VEH_INVALID, data, proc, false);
+}
+
+/**
+ * Find a vehicle of the given type from a specific location.
+ * Vehicles of other types are skipped without calling \a proc for them.
+ * @see FindVehicleOnPos(TileIndex, void *, VehicleFromPosProc *)
+ * @param tile The location on the map
+ * @param type The type of vehicles to consider.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The proc that determines whether a vehicle will be "found".
+ */
+void FindVehicleOnPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc)
+{
+	VehicleFromPos(tile, type, data, proc, false);
 }
 
 /**
@@ -503,7 +542,22 @@ void FindVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc)
  */
 bool HasVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc)
 {
-	return VehicleFromPos(tile, data, proc, true) != nullptr;
+	return VehicleFromPos(tile, VEH_INVALID, data, proc, true) != nullptr;
+}
+
+/**
+ * Checks whether a vehicle of the given type is on a specific location.
+ * Vehicles of other types are skipped without calling \a proc for them.
+ * @see HasVehicleOnPos(TileIndex, void *, VehicleFromPosProc *)
+ * @param tile The location on the map
+ * @param type The type of vehicles to consider.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The \a proc that determines whether a vehicle will be "found".
+ * @return True if proc returned non-nullptr.
+ */
+bool HasVehicleOnPos(TileIndex tile, VehicleType type, void *data, VehicleFromPosProc *proc)
+{
+	return VehicleFromPos(tile, type, data, proc, true) != nullptr;
 }
 
 /**
@@ -535,7 +589,7 @@ CommandCost EnsureNoVehicleOnGround(TileIndex tile)
 	 * error message only (which may be different for different machines).
 	 * Such a message does not affect MP synchronisation.
 	 */
-	Vehicle *v = VehicleFromPos(tile, &z, &EnsureNoVehicleProcZ, true);
+	Vehicle *v = VehicleFromPos(tile, VEH_INVALID, &z, &EnsureNoVehicleProcZ, true);
 	if (v != nullptr) return_cmd_error(STR_ERROR_TRAIN_IN_THE_WAY + v->type);
 	return CommandCost();
 }
@@ -562,8 +616,8 @@ CommandCost TunnelBridgeIsFree(TileIndex tile, TileIndex endtile, const Vehicle
 	 * error message only (which may be different for different machines).
 	 * Such a message does not affect MP synchronisation.
 	 */
-	Vehicle *v = VehicleFromPos(tile, const_cast<Vehicle *>(ignore), &GetVehicleTunnelBridgeProc, true);
-	if (v == nullptr) v = VehicleFromPos(endtile, const_cast<Vehicle *>(ignore), &GetVehicleTunnelBridgeProc, true);
+	Vehicle *v = VehicleFromPos(tile, VEH_INVALID, const_cast<Vehicle *>(ignore), &GetVehicleTunnelBridgeProc, true);
+	if (v == nullptr) v = VehicleFromPos(endtile, VEH_INVALID, const_cast<Vehicle *>(ignore), &GetVehicleTunnelBridgeProc, true);
 
 	if (v != nullptr) return_cmd_error(STR_ERROR_TRAIN_IN_THE_WAY + v->type);
 	return CommandCost();
@@ -595,15 +649,15 @@ CommandCost EnsureNoTrainOnTrackBits(TileIndex tile, TrackBits track_bits)
 	 * error message only (which may be different for different machines).
 	 * Such a message does not affect MP synchronisation.
 	 */
-	Vehicle *v = VehicleFromPos(tile, &track_bits, &EnsureNoTrainOnTrackProc, true);
+	Vehicle *v = VehicleFromPos(tile, VEH_TRAIN, &track_bits, &EnsureNoTrainOnTrackProc, true);
 	if (v != nullptr) return_cmd_error(STR_ERROR_TRAIN_IN_THE_WAY + v->type);
 	return CommandCost();
 }
 
 static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 {
-	Vehicle **old_hash = v->hash_tile_current;
-	Vehicle **new_hash;
+	VehicleTileHashBucket *old_hash = v->hash_tile_current;
+	VehicleTileHashBucket *new_hash;
 
 	if (remove) {
 		new_hash = nullptr;
@@ -613,20 +667,24 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 		new_hash = &_vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
 	}
 
-	if (old_hash == new_hash) return;
+	if (old_hash == new_hash) {
+		/* The vehicle may still have moved to another tile within the same bucket. */
+		if (new_hash != nullptr) (*new_hash)[v->hash_tile_pos].tile = v->tile;
+		return;
+	}
 
-	/* Remove from the old position in the hash table */
+	/* Remove from the old position in the hash table by moving the last entry of the bucket in its place */
 	if (old_hash != nullptr) {
-		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
-		*v->hash_tile_prev = v->hash_tile_next;
+		VehicleTileHashEntry last = old_hash->back();
+		(*old_hash)[v->hash_tile_pos] = last;
+		last.v->hash_tile_pos = v->hash_tile_pos;
+		old_hash->pop_back();
 	}
 
-	/* Insert vehicle at beginning of the new position in the hash table */
+	/* Insert vehicle at the end of the new position in the hash table */
 	if (new_hash != nullptr) {
-		v->hash_tile_next = *new_hash;
-		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
-		v->hash_tile_prev = new_hash;
-		*new_hash = v;
+		v->hash_tile_pos = (uint)new_hash->size();
+		new_hash->push_back({v->tile, v->type, v});
 	}
 
 	/* Remember current hash position */
@@ -663,7 +721,7 @@ void ResetVehicleHash()
 {
 	for (Vehicle *v : Vehicle::Iterate()) { v->hash_tile_current = nullptr; }
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
-	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
+	for (VehicleTileHashBucket &bucket : _vehicle_tile_hash) bucket.clear();
 }
 
 void ResetVehicleColourMap()
@@ -678,9 +736,72 @@ void ResetVehicleColourMap()
 using AutoreplaceMap = std::map<Vehicle *, bool>;
 static AutoreplaceMap _vehicles_to_autoreplace;
 
+/**
+ * Bitmap, indexed by VehicleID, of the vehicles that are ticked by CallVehicleTicks().
+ * Of trains, road vehicles, ships and aircraft only the first vehicle of each chain is
+ * in here; the other parts are handled together with their chain. Effect and disaster
+ * vehicles are always in here.
+ */
+static std::vector<uint64_t> _tick_vehicles;
+
+/**
+ * Does the given vehicle get ticked by itself, or together with its chain?
+ * @param v The vehicle to check.
+ * @return True iff the vehicle belongs in _tick_vehicles.
+ */
+static inline bool IsTickVehicle(const Vehicle *v)
+{
+	return v->Previous() == nullptr || !IsCompanyBuildableVehicleType(v);
+}
+
+/**
+ * Add a vehicle to, or remove it from, the vehicles that are ticked.
+ * @param index The index of the vehicle.
+ * @param tick Whether the vehicle should be ticked.
+ */
+static void SetTickVehicle(size_t index, bool tick)
+{
+	size_t word = index / 64;
+	if (word >= _tick_vehicles.size()) {
+		if (!tick) return;
+		_tick_vehicles.resize(word + 1);
+	}
+	SB(_tick_vehicles[word], index % 64, 1, tick ? 1 : 0);
+}
+
+/**
+ * Find the first vehicle to tick at or after the given index.
+ * @param index The index to start searching from.
+ * @return The index of the vehicle, or SIZE_MAX when there is none.
+ */
+static size_t FindNextTickVehicle(size_t index)
+{
+	size_t word = index / 64;
+	if (word >= _tick_vehicles.size()) return SIZE_MAX;
+
+	uint64_t bits = _tick_vehicles[word] & (UINT64_MAX << (index % 64));
+	while (bits == 0) {
+		if (++word == _tick_vehicles.size()) return SIZE_MAX;
+		bits = _tick_vehicles[word];
+	}
+	return word * 64 + FindFirstBit(bits);
+}
+
+/**
+ * Rebuild the bitmap of vehicles to tick from the vehicle pool.
+ */
+void RebuildVehicleTickList()
+{
+	_tick_vehicles.clear();
+	for (const Vehicle *v : Vehicle::Iterate()) {
+		if (IsTickVehicle(v)) SetTickVehicle(v->index, true);
+	}
+}
+
 void InitializeVehicles()
 {
 	_vehicles_to_autoreplace.clear();
+	_tick_vehicles.clear();
 	ResetVehicleHash();
 }
 
@@ -807,7 +928,7 @@ void Vehicle::PreDestructor()
 
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
-		st->loading_vehicles.remove(this);
+		st->RemoveLoadingVehicle(this);
 
 		HideFillingPercent(&this->fill_percent_te_id);
 		this->CancelReservation(INVALID_STATION, st);
@@ -882,6 +1003,8 @@ Vehicle::~Vehicle()
 
 	delete v;
 
+	SetTickVehicle(this->index, false);
+
 	UpdateVehicleTileHash(this, true);
 	UpdateVehicleViewportHash(this, INVALID_COORD, 0, this->sprite_cache.old_coord.left, this->sprite_cache.old_coord.top);
 	DeleteVehicleNews(this->index, INVALID_STRING_ID);
@@ -914,6 +1037,9 @@ static void RunVehicleDayProc()
 {
 	if (_game_mode != GM_NORMAL) return;
 
+	/* Search depots for trains that want servicing ahead of their day procs, in parallel when enabled. */
+	FindServiceDepotsForTrains(TimerGameCalendar::date_fract, DAY_TICKS);
+
 	/* Run the day_proc for every DAY_TICKS vehicle starting at TimerGameCalendar::date_fract. */
 	for (size_t i = TimerGameCalendar::date_fract; i < Vehicle::GetPoolSize(); i += DAY_TICKS) {
 		Vehicle *v = Vehicle::Get(i);
@@ -938,6 +1064,86 @@ static void RunVehicleDayProc()
 		/* This is called once per day for each vehicle, but not in the first tick of the day */
 		v->OnNewDay();
 	}
+
+	ClearServiceDepotSearches();
+}
+
+/**
+ * Handling of a vehicle part after it has been ticked: cargo aging and sounds.
+ * @param v The vehicle part.
+ */
+static void PostTickVehicle(Vehicle *v)
+{
+	switch (v->type) {
+		default: break;
+
+		case VEH_TRAIN:
+		case VEH_ROAD:
+		case VEH_AIRCRAFT:
+		case VEH_SHIP: {
+			Vehicle *front = v->First();
+
+			if (v->vcache.cached_cargo_age_period != 0) {
+				v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
+				if (--v->cargo_age_counter == 0) {
+					v->cargo.AgeCargo();
+					v->cargo_age_counter = v->vcache.cached_cargo_age_period;
+				}
+			}
+
+			/* Do not play any sound when crashed */
+			if (front->vehstatus & VS_CRASHED) return;
+
+			/* Do not play any sound when in depot or tunnel */
+			if (v->vehstatus & VS_HIDDEN) return;
+
+			/* Do not play any sound when stopped */
+			if ((front->vehstatus & VS_STOPPED) && (front->type != VEH_TRAIN || front->cur_speed == 0)) return;
+
+			/* Check vehicle type specifics */
+			switch (v->type) {
+				case VEH_TRAIN:
+					if (Train::From(v)->IsWagon()) return;
+					break;
+
+				case VEH_ROAD:
+					if (!RoadVehicle::From(v)->IsFrontEngine()) return;
+					break;
+
+				case VEH_AIRCRAFT:
+					if (!Aircraft::From(v)->IsNormalAircraft()) return;
+					break;
+
+				default:
+					break;
+			}
+
+			v->motion_counter += front->cur_speed;
+			/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
+			if (GB(v->motion_counter, 0, 8) < front->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
+
+			/* Play an alternating running sound every 16 ticks */
+			if (GB(v->tick_counter, 0, 4) == 0) {
+				/* Play running sound when speed > 0 and not braking */
+				bool running = (front->cur_speed > 0) && !(front->vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
+				PlayVehicleSound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
+			}
+
+			break;
+		}
+	}
+}
+
+/**
+ * Tick a vehicle part that is not the first of its chain. Their Tick() does nothing
+ * besides counting ticks, except for the shadow and rotor of aircraft that do not
+ * even do that, so it is done here without the virtual call.
+ * @param v The vehicle part.
+ */
+static void TickVehiclePart(Vehicle *v)
+{
+	if (v->type != VEH_AIRCRAFT) v->tick_counter++;
+	PostTickVehicle(v);
 }
 
 void CallVehicleTicks()
@@ -948,15 +1154,34 @@ void CallVehicleTicks()
 
 	{
 		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
-		for (Station *st : Station::Iterate()) LoadUnloadStation(st);
+		/* Only stations with vehicles in their loading queue have anything to do. Take a
+		 * copy of the set, in station index order, as loading may alter the queues. */
+		static std::vector<StationID> loading_stations;
+		loading_stations.assign(_loading_stations.begin(), _loading_stations.end());
+		for (StationID station : loading_stations) {
+			Station *st = Station::GetIfValid(station);
+			if (st != nullptr) LoadUnloadStation(st);
+		}
 	}
 	PerformanceAccumulator::Reset(PFE_GL_TRAINS);
 	PerformanceAccumulator::Reset(PFE_GL_ROADVEHS);
 	PerformanceAccumulator::Reset(PFE_GL_SHIPS);
 	PerformanceAccumulator::Reset(PFE_GL_AIRCRAFT);
-
-	for (Vehicle *v : Vehicle::Iterate()) {
-		[[maybe_unused]] size_t vehicle_index = v->index;
+	PerformanceAccumulator::Reset(PFE_GL_PF_TRAINS);
+	PerformanceAccumulator::Reset(PFE_GL_PF_ROADVEHS);
+	PerformanceAccumulator::Reset(PFE_GL_PF_SHIPS);
+	PerformanceAccumulator::Reset(PFE_GL_AUTOREPLACE);
+
+	/* Only the first vehicle of a chain is ticked from here. The other parts of the
+	 * chain are handled right before or after it, depending on whether their index
+	 * is lower or higher, so everything happens in the same order as a walk over
+	 * the whole pool would do. */
+	for (size_t vehicle_index = FindNextTickVehicle(0); vehicle_index != SIZE_MAX; vehicle_index = FindNextTickVehicle(vehicle_index + 1)) {
+		Vehicle *v = Vehicle::Get(vehicle_index);
+
+		for (Vehicle *u = v->Next(); u != nullptr; u = u->Next()) {
+			if (u->index < vehicle_index && IsCompanyBuildableVehicleType(u)) TickVehiclePart(u);
+		}
 
 		/* Vehicle could be deleted in this tick */
 		if (!v->Tick()) {
@@ -966,66 +1191,14 @@ void CallVehicleTicks()
 
 		assert(Vehicle::Get(vehicle_index) == v);
 
-		switch (v->type) {
-			default: break;
-
-			case VEH_TRAIN:
-			case VEH_ROAD:
-			case VEH_AIRCRAFT:
-			case VEH_SHIP: {
-				Vehicle *front = v->First();
-
-				if (v->vcache.cached_cargo_age_period != 0) {
-					v->cargo_age_counter = std::min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
-					if (--v->cargo_age_counter == 0) {
-						v->cargo.AgeCargo();
-						v->cargo_age_counter = v->vcache.cached_cargo_age_period;
-					}
-				}
-
-				/* Do not play any sound when crashed */
-				if (front->vehstatus & VS_CRASHED) continue;
-
-				/* Do not play any sound when in depot or tunnel */
-				if (v->vehstatus & VS_HIDDEN) continue;
+		PostTickVehicle(v);
 
-				/* Do not play any sound when stopped */
-				if ((front->vehstatus & VS_STOPPED) && (front->type != VEH_TRAIN || front->cur_speed == 0)) continue;
-
-				/* Check vehicle type specifics */
-				switch (v->type) {
-					case VEH_TRAIN:
-						if (Train::From(v)->IsWagon()) continue;
-						break;
-
-					case VEH_ROAD:
-						if (!RoadVehicle::From(v)->IsFrontEngine()) continue;
-						break;
-
-					case VEH_AIRCRAFT:
-						if (!Aircraft::From(v)->IsNormalAircraft()) continue;
-						break;
-
-					default:
-						break;
-				}
-
-				v->motion_counter += front->cur_speed;
-				/* Play a running sound if the motion counter passes 256 (Do we not skip sounds?) */
-				if (GB(v->motion_counter, 0, 8) < front->cur_speed) PlayVehicleSound(v, VSE_RUNNING);
-
-				/* Play an alternating running sound every 16 ticks */
-				if (GB(v->tick_counter, 0, 4) == 0) {
-					/* Play running sound when speed > 0 and not braking */
-					bool running = (front->cur_speed > 0) && !(front->vehstatus & (VS_STOPPED | VS_TRAIN_SLOWING));
-					PlayVehicleSound(v, running ? VSE_RUNNING_16 : VSE_STOPPED_16);
-				}
-
-				break;
-			}
+		for (Vehicle *u = v->Next(); u != nullptr; u = u->Next()) {
+			if (u->index > vehicle_index && IsCompanyBuildableVehicleType(u)) TickVehiclePart(u);
 		}
 	}
 
+	PerformanceAccumulator framerate(PFE_GL_AUTOREPLACE);
 	Backup<CompanyID> cur_company(_current_company, FILE_LINE);
 	for (auto &it : _vehicles_to_autoreplace) {
 		Vehicle *v = it.first;
@@ -2279,7 +2452,7 @@ void Vehicle::LeaveStation()
 	this->current_order.MakeLeaveStation();
 	Station *st = Station::Get(this->last_station_visited);
 	this->CancelReservation(INVALID_STATION, st);
-	st->loading_vehicles.remove(this);
+	st->RemoveLoadingVehicle(this);
 
 	HideFillingPercent(&this->fill_percent_te_id);
 	trip_occupancy = CalcPercentVehicleFilled(this, nullptr);
@@ -2742,6 +2915,7 @@ void Vehicle::SetNext(Vehicle *next)
 			v->first = this->next;
 		}
 		this->next->previous = nullptr;
+		SetTickVehicle(this->next->index, true);
 	}
 
 	this->next = next;
@@ -2753,6 +2927,7 @@ void Vehicle::SetNext(Vehicle *next)
 		for (Vehicle *v = this->next; v != nullptr; v = v->Next()) {
 			v->first = this->first;
 		}
+		SetTickVehicle(this->next->index, IsTickVehicle(this->next));
 	}
 }
 
@@ -202,6 +202,7 @@ extern VehiclePool _vehicle_pool;
 
 /* Some declarations of functions, so we can make them friendly */
 struct GroundVehicleCache;
+struct VehicleTileHashEntry;
 struct LoadgameState;
 extern bool LoadOldVehicle(LoadgameState *ls, int num);
 extern void FixOldVehicles();
@@ -277,9 +278,8 @@ public:
 	Vehicle *hash_viewport_next;        ///< NOSAVE: Next vehicle in the visual location hash.
 	Vehicle **hash_viewport_prev;       ///< NOSAVE: Previous vehicle in the visual location hash.
 
-	Vehicle *hash_tile_next;            ///< NOSAVE: Next vehicle in the tile location hash.
-	Vehicle **hash_tile_prev;           ///< NOSAVE: Previous vehicle in the tile location hash.
-	Vehicle **hash_tile_current;        ///< NOSAVE: Cache of the current hash chain.
+	std::vector<VehicleTileHashEntry> *hash_tile_current; ///< NOSAVE: Bucket of the tile location hash the vehicle is in.
+	uint hash_tile_pos;                 ///< NOSAVE: Position of the vehicle in its tile location hash bucket.
 
 	SpriteID colourmap;                 ///< NOSAVE: cached colour mapping
 
@@ -12,6 +12,14 @@
 #include "../blitter/factory.hpp"
 #include "../saveload/saveload.h"
 #include "../window_func.h"
+#include "../openttd.h"
+#include "../framerate_type.h"
+#include "../map_func.h"
+#include "../string_func.h"
+#include "../core/random_func.hpp"
+#include "../timer/timer_game_tick.h"
+#include "../3rdparty/md5/md5.h"
+#include "../pathfinder/yapf/yapf_cache.h"
 #include "null_v.h"
 
 #include "../safeguards.h"
@@ -29,6 +37,7 @@ const char *VideoDriver_Null::Start(const StringList &parm)
 	this->UpdateAutoResolution();
 
 	this->ticks = GetDriverParamInt(parm, "ticks", 1000);
+	this->benchmark = GetDriverParamBool(parm, "benchmark");
 	_screen.width  = _screen.pitch = _cur_resolution.width;
 	_screen.height = _cur_resolution.height;
 	_screen.dst_ptr = nullptr;
@@ -46,6 +55,11 @@ void VideoDriver_Null::MakeDirty(int left, int top, int width, int height) {}
 
 void VideoDriver_Null::MainLoop()
 {
+	if (this->benchmark) {
+		this->RunBenchmark();
+		return;
+	}
+
 	uint i;
 
 	for (i = 0; i < this->ticks; i++) {
@@ -61,6 +75,74 @@ void VideoDriver_Null::MainLoop()
 	}
 }
 
+/**
+ * Load the game, then run the requested number of game ticks as fast as possible.
+ * Afterwards print the time spent per tick in each performance element, and a
+ * checksum of the game state so runs can be compared for determinism.
+ */
+void VideoDriver_Null::RunBenchmark()
+{
+	/* Scan the NewGRFs and load the savegame. */
+	while (_switch_mode != SM_NONE) {
+		::GameLoop();
+		if (_exit_game) return;
+	}
+	if (_game_mode != GM_NORMAL) {
+		fmt::print(stderr, "Failed to load the savegame for the benchmark\n");
+		return;
+	}
+
+	if (_pause_mode != PM_UNPAUSED) {
+		Debug(misc, 0, "Unpausing the game to run the benchmark");
+		_pause_mode = PM_UNPAUSED;
+	}
+
+	/* Ticks where the game waits for the link graph do not advance the
+	 * game state, so count ticks by the game tick counter instead. */
+	const uint64_t last_tick = TimerGameTick::counter + this->ticks;
+	const YapfSegmentCacheStats cache_stats_start = YapfGetSegmentCacheStats();
+	const YapfRoadRouteCacheStats route_stats_start = YapfGetRoadRouteCacheStats();
+	StartPerformanceBenchmark();
+	auto start_time = std::chrono::steady_clock::now();
+	while (TimerGameTick::counter < last_tick) {
+		if ((_pause_mode & ~PM_PAUSED_LINK_GRAPH) != PM_UNPAUSED) {
+			fmt::print(stderr, "The game was paused during the benchmark, stopping early\n");
+			break;
+		}
+		::StateGameLoop();
+	}
+	auto end_time = std::chrono::steady_clock::now();
+
+	uint64_t ticks = this->ticks - (last_tick - TimerGameTick::counter);
+	double total_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
+	fmt::print("Ran {} ticks in {:.1f} ms, {:.3f} ms per tick\n", ticks, total_ms, ticks > 0 ? total_ms / ticks : 0.0);
+	FinishPerformanceBenchmark();
+
+	const YapfSegmentCacheStats cache_stats = YapfGetSegmentCacheStats();
+	const uint64_t hits = cache_stats.hits - cache_stats_start.hits;
+	const uint64_t misses = cache_stats.misses - cache_stats_start.misses;
+	fmt::print("Rail segment cost cache: {} hits, {} misses ({:.1f}% hit rate), {} segments invalidated, {} flushes\n",
+			hits, misses, hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0,
+			cache_stats.invalidated - cache_stats_start.invalidated, cache_stats.flushes - cache_stats_start.flushes);
+
+	const YapfRoadRouteCacheStats route_stats = YapfGetRoadRouteCacheStats();
+	fmt::print("Shared road vehicle routes: {} reused, {} searched\n",
+			route_stats.hits - route_stats_start.hits, route_stats.misses - route_stats_start.misses);
+
+	/* A difference in the simulation nearly always shows up on the map or in the random state. */
+	Md5 checksum;
+	for (auto tile : Map::Iterate()) {
+		const byte data[] = {
+			tile.type(), tile.height(), tile.m1(), (byte)GB(tile.m2(), 0, 8), (byte)GB(tile.m2(), 8, 8), tile.m3(), tile.m4(), tile.m5(), tile.m6(), tile.m7(), (byte)GB(tile.m8(), 0, 8), (byte)GB(tile.m8(), 8, 8),
+		};
+		checksum.Append(data, sizeof(data));
+	}
+	MD5Hash digest;
+	checksum.Finish(digest);
+	fmt::print("Random state: {:08x} {:08x}\n", _random.state[0], _random.state[1]);
+	fmt::print("Map checksum: {}\n", FormatArrayAsHex(digest));
+}
+
 bool VideoDriver_Null::ChangeResolution(int w, int h) { return false; }
 
 bool VideoDriver_Null::ToggleFullscreen(bool fs) { return false; }
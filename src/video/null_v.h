@@ -15,7 +15,10 @@
 /** The null video driver. */
 class VideoDriver_Null : public VideoDriver {
 private:
-	uint ticks; ///< Amount of ticks to run.
+	uint ticks;     ///< Amount of ticks to run.
+	bool benchmark; ///< Whether to time the ticks and print the results.
+
+	void RunBenchmark();
 
 public:
 	const char *Start(const StringList &param) override;
@@ -16,6 +16,8 @@ enum FramerateWindowWidgets {
 	WID_FRW_RATE_GAMELOOP,
 	WID_FRW_RATE_DRAWING,
 	WID_FRW_RATE_FACTOR,
+	WID_FRW_ROAD_ROUTE_CACHE,
+	WID_FRW_LINKGRAPH_JOBS,
 	WID_FRW_INFO_DATA_POINTS,
 	WID_FRW_TIMES_NAMES,
 	WID_FRW_TIMES_CURRENT,